@@ -2,20 +2,83 @@
 // Created by easy on 14.05.23.
 //
 
+#if defined(__linux__)
+#define _DEFAULT_SOURCE
+#include <sys/mman.h>
+#endif
 
 #include "dynarrlo.h"
 #include <stdbool.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+#if DAL_STATS
+#include <time.h>
+#endif
+
 
 // Returns the lesser of the two arguments.
 #define MIN(a, b) ((a) <= (b) ? (a) : (b))
 // Returns the greater of the two arguments.
 #define MAX(a, b) ((a) >= (b) ? (a) : (b))
 
+// Flag of DynarrLO.flags requesting transparent huge pages for the array.
+#define FLAG_HUGEPAGES 1
+// Flag of DynarrLO.flags marking an array that the DynarrLO didn't allocate.
+#define FLAG_BORROWED 2
+// Bits of DynarrLO.flags from this one up hold the shift of the shrink
+// threshold, see dal_setAutoShrink().
+#define SHRINK_SHIFT DAL_SHRINK_SHIFT
+#define MAX_SHRINK_LOG2 15
+
+// Allocations of at least this size are served by mmap() in whole pages.
+#define LARGE_SIZE ((size_t) 128 << 10)
+#define PAGE_SIZE ((size_t) 4 << 10)
+
+_Static_assert(DAL_SMALL_CAPACITY >= DAL_MIN_CAPACITY,
+               "DAL_SMALL_CAPACITY must not be less than DAL_MIN_CAPACITY");
+
+
+static size_t itemsToBytes(const DynarrLO *d, size_t n) {
+    return n * d->elemSize;
+}
+
+
+static unsigned char *bytes(const DynarrLO *d) {
+    return (unsigned char *) d->array;
+}
+
+
+// Address of the element at index, regardless of the element size.
+static unsigned char *elemAt(const DynarrLO *d, size_t index) {
+    return bytes(d) + itemsToBytes(d, index);
+}
+
+
+/**
+ * Byte offset of elem inside the elements of d or SIZE_MAX if it points
+ * elsewhere. Lets functions copying a single element keep track of it when the
+ * array is reallocated or shifted underneath.
+ */
+static size_t offsetIn(const DynarrLO *d, const void *elem) {
+    uintptr_t start = (uintptr_t) d->array;
+    uintptr_t p = (uintptr_t) elem;
+
+    return elem && p >= start && p - start < itemsToBytes(d, d->length)
+           ? (size_t) (p - start) : SIZE_MAX;
+}
+
 
-static size_t itemsToBytes(size_t n) {
-    return n * sizeof(void *);
+// Reports an error through an optional out-parameter.
+static void setError(DAL_ERROR *error, DAL_ERROR value) {
+    if (error)
+        *error = value;
 }
 
 
@@ -24,39 +87,304 @@ static size_t grownCapacity(size_t n) {
 }
 
 
+static size_t alignment(const DynarrLO *d) {
+    return (size_t) 1 << d->alignLog2;
+}
+
+
+static size_t log2Floor(size_t n) {
+#if defined(__GNUC__) || defined(__clang__)
+    return sizeof(unsigned long long) * CHAR_BIT - 1 -
+           (size_t) __builtin_clzll(n);
+#else
+    size_t log = 0;
+
+    while (n >>= 1)
+        ++log;
+
+    return log;
+#endif
+}
+
+
+#if DAL_STATS
+
+// Adds n to a counter of the statistics of d.
+#define COUNT(d, counter, n) ((d)->stats.counter += (n))
+
+// Counts an out-of-range error reported by the error flag of d.
+#define COUNT_ERROR(d) COUNT(d, outOfRange, (d)->error == DAL_OUTOFRANGE)
+
+// Records the length and capacity of d if they are the largest so far.
+#define COUNT_PEAK(d) countPeak(d)
+
+#define START_CLOCK() clockNs()
+
+
+static void countPeak(DynarrLO *d) {
+    d->stats.peakLength = MAX(d->stats.peakLength, d->length);
+    d->stats.peakCapacity = MAX(d->stats.peakCapacity, d->capacity);
+}
+
+
+static uint64_t clockNs(void) {
+    struct timespec t;
+#if defined(CLOCK_MONOTONIC)
+    clock_gettime(CLOCK_MONOTONIC, &t);
+#else
+    timespec_get(&t, TIME_UTC);
+#endif
+    return (uint64_t) t.tv_sec * 1000000000 + (uint64_t) t.tv_nsec;
+}
+
+
+// Counts a reallocation of the array that started at start.
+static void countResize(DynarrLO *d, uint64_t start) {
+    uint64_t ns = clockNs() - start;
+    size_t bucket = ns ? log2Floor((size_t) ns) : 0;
+
+    ++d->stats.latency[MIN(bucket, DAL_STATS_BUCKETS - 1)];
+    ++d->stats.reallocs;
+    countPeak(d);
+}
+
+#else
+
+#define COUNT(d, counter, n) ((void) 0)
+#define COUNT_ERROR(d) ((void) 0)
+#define COUNT_PEAK(d) ((void) 0)
+#define START_CLOCK() 0
+#define countResize(d, start) ((void) (start))
+
+#endif // DAL_STATS
+
+
+// Step of the additive and capped growth strategies in elements.
+static size_t growthStep(const DynarrLO *d) {
+    size_t step = d->growthStepLog2 ? (size_t) 1 << d->growthStepLog2
+                                    : DAL_GROWTH_STEP;
+    return MAX(step / d->elemSize, 1);
+}
+
+
+static size_t nextCapacity(const DynarrLO *d) {
+    size_t n = d->capacity;
+
+    switch (d->growth) {
+        case DAL_GROWTH_DOUBLE:
+            return n + n;
+        case DAL_GROWTH_ADDITIVE:
+            return n + growthStep(d);
+        case DAL_GROWTH_CAPPED:
+            return n + MIN(n / 2, growthStep(d));
+        default:
+            return grownCapacity(n);
+    }
+}
+
+
+/**
+ * Rounds an allocation size up to the size class an allocator serves it from
+ * anyway: multiples of 16 bytes for small sizes, four classes per power of two
+ * for medium ones and whole pages for sizes that are mapped directly.
+ */
+static size_t sizeClass(size_t size) {
+    size_t step = 16;
+
+    if (size >= LARGE_SIZE)
+        step = PAGE_SIZE;
+    else if (size > 256)
+        step = (size_t) 1 << (log2Floor(size - 1) - 2);
+
+    return (size + step - 1) & ~(step - 1);
+}
+
+
+/**
+ * Raises a capacity the array grows to so that the allocation, including the
+ * padding element and the bytes needed for the alignment, fills its size class.
+ */
+static size_t classCapacity(const DynarrLO *d, size_t capacity) {
+    size_t extra = d->alignLog2 ? alignment(d) : 0;
+    size_t size = itemsToBytes(d, capacity + 1) + extra;
+
+    // Sizes this large would overflow, let realloc() fail on them as it is
+    if (size < itemsToBytes(d, capacity) || size > SIZE_MAX / 2)
+        return capacity;
+
+    return (sizeClass(size) - extra) / d->elemSize - 1;
+}
+
+
+/**
+ * Claims the slack the standard allocator of glibc added to an allocation of
+ * our own. Other allocators are unknown, so their allocations are taken as is.
+ */
+static size_t usableCapacity(const DynarrLO *d,
+                             void *memory,
+                             size_t capacity) {
+
+#if defined(__GLIBC__)
+    if (d->realloc == realloc && !d->alignLog2)
+        return MAX(capacity, malloc_usable_size(memory) / d->elemSize - 1);
+#else
+    (void) d, (void) memory;
+#endif
+    return capacity;
+}
+
+
 static bool growthRequired(const DynarrLO *d) {
     return d->length >= d->capacity;
 }
 
 
-static DAL_ERROR setCapacity(DynarrLO *d, size_t capacity) {
+/**
+ * Distance between the allocation of an aligned array and the array itself.
+ * Stored right in front of the array, inside the over-allocated bytes.
+ */
+static size_t *alignOffset(unsigned char *array) {
+    return (size_t *) array - 1;
+}
+
+
+// Address of the allocation holding the array.
+static void *allocationOf(const DynarrLO *d) {
+    if (!d->alignLog2 || !d->array)
+        return d->array;
+
+    return bytes(d) - *alignOffset(bytes(d));
+}
+
+
+static void adviseHugePages(const DynarrLO *d, unsigned char *memory,
+                            size_t size) {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    uintptr_t huge = DAL_HUGEPAGE_SIZE;
+    uintptr_t start = ((uintptr_t) memory + huge - 1) & ~(huge - 1);
+    uintptr_t end = ((uintptr_t) memory + size) & ~(huge - 1);
+
+    if ((d->flags & FLAG_HUGEPAGES) && end > start)
+        madvise((void *) start, end - start, MADV_HUGEPAGE);
+#else
+    (void) d, (void) memory, (void) size;
+#endif
+}
+
+
+/**
+ * Reallocates the array so that it holds capacity elements plus the padding
+ * element and starts at a multiple of the alignment. The contents are kept.
+ * @return Array or NULL on failure, in which case the old array is untouched.
+ */
+static unsigned char *reallocArray(DynarrLO *d, size_t capacity) {
+    size_t size = itemsToBytes(d, capacity + 1);
+
+    // Borrowed storage is copied into the first array of our own
+    if (d->flags & FLAG_BORROWED) {
+        DynarrLO owned = *d;
+        owned.array = NULL;
+        owned.flags &= ~FLAG_BORROWED;
+        unsigned char *memory = reallocArray(&owned, capacity);
+
+        if (memory)
+            memcpy(memory, d->array,
+                   itemsToBytes(d, MIN(d->length, capacity)));
+
+        return memory;
+    }
+
+    if (!d->alignLog2)
+        return d->realloc(d->array, size);
+
+    size_t align = alignment(d);
+    size_t oldOffset = d->array ? *alignOffset(bytes(d)) : 0;
+    unsigned char *raw = d->realloc(allocationOf(d), size + align);
+    if (!raw)
+        return NULL;
+
+    // Offset lies within [1, align], leaving room for storing it in front
+    unsigned char *memory = (unsigned char *)
+            (((uintptr_t) raw + align) & ~(uintptr_t) (align - 1));
+    size_t offset = (size_t) (memory - raw);
+
+    // realloc() kept the contents at the old offset
+    if (d->array && offset != oldOffset)
+        memmove(memory,
+                raw + oldOffset,
+                MIN(size, itemsToBytes(d, d->capacity + 1)));
+
+    *alignOffset(memory) = offset;
+    return memory;
+}
+
+
+/**
+ * Sets the capacity of the array. A growing array is additionally given all
+ * the room of its size class.
+ */
+static DAL_ERROR resize(DynarrLO *d, size_t capacity, bool growing) {
     capacity = MAX(capacity, DAL_MIN_CAPACITY);
 
+    if (growing)
+        capacity = classCapacity(d, capacity);
+
     if (capacity == d->capacity)
         return DAL_OK;
 
+    // Borrowed storage can't be freed, so shrinking it merely moves the padding
+    if ((d->flags & FLAG_BORROWED) && capacity < d->capacity) {
+        memset(elemAt(d, capacity), 0, d->elemSize);
+        d->length = MIN(d->length, capacity);
+        d->capacity = capacity;
+        return DAL_OK;
+    }
+
     // Allocate 1 padding element
-    void **memory = d->realloc(d->array, itemsToBytes(capacity + 1));
+    uint64_t start = START_CLOCK();
+    unsigned char *memory = reallocArray(d, capacity);
     if (!memory)
         return DAL_ALLOCFAIL;
 
+    d->flags &= ~FLAG_BORROWED;
+
+    if (growing)
+        capacity = usableCapacity(d, memory, capacity);
+
     // Initialise padding element to zero
-    memory[capacity] = NULL;
-    d->array = memory;
+    memset(memory + itemsToBytes(d, capacity), 0, d->elemSize);
+    adviseHugePages(d, memory, itemsToBytes(d, capacity + 1));
+    d->array = (void **) memory;
     d->length = MIN(d->length, capacity);
     d->capacity = capacity;
+    countResize(d, start);
 
     return DAL_OK;
 }
 
 
+static DAL_ERROR setCapacity(DynarrLO *d, size_t capacity) {
+    return resize(d, capacity, false);
+}
+
+
+/**
+ * Called by every removal. Arrays that didn't opt in only pay for a single
+ * well-predicted branch, so the branchless removals stay cheap.
+ */
+static void autoShrink(DynarrLO *d) {
+    if (d->flags >> SHRINK_SHIFT)
+        dal_autoShrink(d);
+}
+
+
 /**
  * Will grow the array if it is necessary to do so. Does nothing on failure.
  * @return True iff memory allocation failed.
  */
 static bool growArray(DynarrLO *d) {
     return growthRequired(d) &&
-    (d->error = setCapacity(d, grownCapacity(d->capacity)));
+    (d->error = resize(d, nextCapacity(d), true));
 }
 
 
@@ -66,9 +394,166 @@ static bool growArray(DynarrLO *d) {
  * @return True iff memory allocation failed.
  */
 static bool growArrayArbitrary(DynarrLO *d, size_t num) {
-    size_t size = MAX(grownCapacity(d->capacity), num);
+    size_t size = MAX(nextCapacity(d), num);
+
+    return num > d->capacity && (d->error = resize(d, size, true));
+}
+
+
+
+/**
+ * A slab of the object arena. Objects are carved from data in allocation order
+ * and the slab is handed back to \p free() once all of them have been freed.
+ */
+struct DalSlab {
+    struct DalSlab *prev;   // Next older slab
+    size_t size;            // Usable bytes in data
+    size_t used;            // Bytes handed out so far
+    size_t last;            // Offset of the most recent object
+    size_t live;            // Objects not yet freed
+    max_align_t data[];
+};
+
+
+// Rounds an object size up so the next object is suitably aligned.
+static size_t arenaSize(size_t size) {
+    size_t align = _Alignof(max_align_t);
+    size += !size;
+    return (size + align - 1) / align * align;
+}
+
+
+static bool slabContains(const DalSlab *s, const void *obj) {
+    uintptr_t start = (uintptr_t) s->data;
+    uintptr_t addr = (uintptr_t) obj;
+    return addr - start < s->size;
+}
+
+
+static DalSlab *pushSlab(DynarrLO *d, size_t size) {
+    DalSlab *s = d->realloc(NULL, sizeof *s + size);
+    if (!s)
+        return NULL;
+
+    s->prev = d->slabs;
+    s->size = size;
+    s->used = 0;
+    s->last = 0;
+    s->live = 0;
+    d->slabs = s;
+    return s;
+}
+
+
+/**
+ * Allocates an object, either from the arena or with the realloc function.
+ * @return Object or NULL on failure.
+ */
+static void *allocObject(DynarrLO *d, size_t size) {
+    DalSlab *s = d->slabs;
+
+    if (!s)
+        return d->realloc(NULL, size);
+
+    size = arenaSize(size);
+
+    if (s->size - s->used < size) {
+        DalSlab *full = s;
+
+        // On failure the arena keeps its current slab and stays in use
+        if (!(s = pushSlab(d, MAX(grownCapacity(full->size), size))))
+            return NULL;
+
+        // An empty slab that is too small is of no further use
+        if (!full->live) {
+            s->prev = full->prev;
+            d->free(full);
+        }
+    }
+
+    s->last = s->used;
+    s->used += size;
+    ++s->live;
+    return (unsigned char *) s->data + s->last;
+}
+
+
+// Slab holding obj or NULL if obj wasn't allocated from the arena.
+static DalSlab *findSlab(const DynarrLO *d, const void *obj) {
+    DalSlab *s = d->slabs;
+
+    while (s && !slabContains(s, obj))
+        s = s->prev;
 
-    return num > d->capacity && (d->error = setCapacity(d, size));
+    return s;
+}
+
+
+/**
+ * Hands an object back to its slab, which is released as a whole once it is
+ * empty. Only then is the list of slabs walked to unlink it.
+ * @return False iff the slab was released.
+ */
+static bool releaseObject(DynarrLO *d, DalSlab *s, const void *obj) {
+    if (--s->live) {
+        // Allow immediate reuse of the most recent object
+        bool last = (unsigned char *) s->data + s->last == obj;
+        s->used = last ? s->last : s->used;
+        return true;
+    }
+
+    if (s == d->slabs) {
+        s->used = 0;
+        return true;
+    }
+
+    DalSlab **link = &d->slabs;
+
+    while (*link != s)
+        link = &(*link)->prev;
+
+    *link = s->prev;
+    d->free(s);
+    return false;
+}
+
+
+/**
+ * Frees an object. Objects of the arena are handed back to their slab, any
+ * other object is passed to the free function. The newest slab is searched
+ * first, so freeing recent objects doesn't walk the list of slabs.
+ */
+static void freeObject(DynarrLO *d, void *obj) {
+    DalSlab *s = findSlab(d, obj);
+
+    if (s)
+        releaseObject(d, s, obj);
+    else
+        d->free(obj);
+}
+
+
+/**
+ * Frees num consecutive objects and sets them to NULL. Objects appended in
+ * order lie in the same slab, so the slab of the previous object is tried
+ * first and the list of slabs is only searched when the range crosses into
+ * another one. Each slab emptied by the range is released at once.
+ */
+static void freeObjects(DynarrLO *d, void **objs, size_t num) {
+    DalSlab *hint = NULL;
+
+    for (size_t i = 0; i < num; ++i) {
+        void *obj = objs[i];
+        DalSlab *s = hint && slabContains(hint, obj) ? hint
+                                                     : findSlab(d, obj);
+
+        if (!s)
+            d->free(obj);
+        else
+            hint = releaseObject(d, s, obj) ? s : NULL;
+    }
+
+    memset(objs, 0, num * sizeof *objs);
 }
 
 
@@ -78,31 +563,215 @@ DAL_ERROR dal_createDynarrLO(DynarrLO *d,
                              void *(*realloc) (void *, size_t),
                              void (*free) (void *)) {
 
-    if (!d || !realloc || !free)
+    return dal_createDynarrLOSized(d, capacity, sizeof(void *), realloc, free);
+}
+
+
+DAL_ERROR dal_createDynarrLOSized(DynarrLO *d,
+                                  size_t capacity,
+                                  size_t elemSize,
+                                  void *(*realloc) (void *, size_t),
+                                  void (*free) (void *)) {
+
+    return dal_createDynarrLOAligned(d, capacity, elemSize, 0, realloc, free);
+}
+
+
+DAL_ERROR dal_createDynarrLOAligned(DynarrLO *d,
+                                   size_t capacity,
+                                   size_t elemSize,
+                                   size_t alignment,
+                                   void *(*realloc) (void *, size_t),
+                                   void (*free) (void *)) {
+
+    if (!d || !elemSize || !realloc || !free)
         return DAL_NULLARG;
 
+    unsigned char alignLog2 = 0;
+
+    // Smaller alignments are already guaranteed by realloc()
+    if (alignment > _Alignof(max_align_t))
+        while ((size_t) 1 << alignLog2 < alignment)
+            ++alignLog2;
+
+    DynarrLO tmp = {
+        .elemSize = elemSize,
+        .alignLog2 = alignLog2,
+        .realloc = realloc,
+        .free = free
+    };
+
     capacity = MAX(capacity, DAL_MIN_CAPACITY);
 
     // Allocate 1 padding element
-    void **memory = realloc(NULL, itemsToBytes(capacity + 1));
+    unsigned char *memory = reallocArray(&tmp, capacity);
     if (!memory)
         return DAL_ALLOCFAIL;
 
     // Initialise padding element to zero
-    memory[capacity] = NULL;
-    d->array = memory;
-    d->length = 0;
-    d->capacity = capacity;
-    d->error = DAL_OK;
-    d->realloc = realloc;
-    d->free = free;
+    memset(memory + capacity * elemSize, 0, elemSize);
+    tmp.array = (void **) memory;
+    tmp.capacity = capacity;
+    COUNT_PEAK(&tmp);
+    *d = tmp;
 
     return DAL_OK;
 }
 
 
+DAL_ERROR dal_createFromBuffer(DynarrLO *d,
+                               void *buffer,
+                               size_t size,
+                               size_t elemSize,
+                               void *(*realloc) (void *, size_t),
+                               void (*free) (void *)) {
+
+    if (!d || !buffer || !elemSize || !realloc || !free)
+        return DAL_NULLARG;
+
+    // Leave room for the padding element
+    size_t capacity = size / elemSize;
+
+    if (capacity <= DAL_MIN_CAPACITY)
+        return DAL_OUTOFRANGE;
+
+    --capacity;
+    memset((unsigned char *) buffer + capacity * elemSize, 0, elemSize);
+    *d = (DynarrLO) {
+        .array = buffer,
+        .capacity = capacity,
+        .elemSize = elemSize,
+        .flags = FLAG_BORROWED,
+        .realloc = realloc,
+        .free = free
+    };
+
+    COUNT_PEAK(d);
+    return DAL_OK;
+}
+
+
+DAL_ERROR dal_createSmall(DalSmallDynarrLO *s,
+                          void *(*realloc) (void *, size_t),
+                          void (*free) (void *)) {
+
+    if (!s)
+        return DAL_NULLARG;
+
+    return dal_createFromBuffer(&s->d, s->buffer, sizeof s->buffer,
+                                sizeof(void *), realloc, free);
+}
+
+
+DAL_ERROR dal_clone(DynarrLO *dst, const DynarrLO *src) {
+    if (!dst || !src)
+        return DAL_NULLARG;
+
+    size_t alignment = src->alignLog2 ? (size_t) 1 << src->alignLog2 : 0;
+    DynarrLO tmp;
+    DAL_ERROR error = dal_createDynarrLOAligned(&tmp, src->length,
+                                                src->elemSize, alignment,
+                                                src->realloc, src->free);
+    if (error)
+        return error;
+
+    memcpy(tmp.array, src->array, itemsToBytes(src, src->length));
+    tmp.length = src->length;
+    COUNT_PEAK(&tmp);
+
+    if (src->flags & FLAG_HUGEPAGES)
+        dal_useHugePages(&tmp);
+
+    tmp.flags |= src->flags & ~((1 << SHRINK_SHIFT) - 1);
+    tmp.growth = src->growth;
+    tmp.growthStepLog2 = src->growthStepLog2;
+
+    *dst = tmp;
+    return DAL_OK;
+}
+
+
+void dal_useHugePages(DynarrLO *d) {
+    d->flags |= FLAG_HUGEPAGES;
+    adviseHugePages(d, bytes(d), itemsToBytes(d, d->capacity + 1));
+}
+
+
+void dal_useArena(DynarrLO *d, size_t slabSize) {
+    d->error = DAL_OK;
+
+    if (!d->slabs && !pushSlab(d, arenaSize(slabSize)))
+        d->error = DAL_ALLOCFAIL;
+}
+
+
+void dal_setGrowth(DynarrLO *d, DAL_GROWTH strategy, size_t step) {
+    if ((d->error = strategy > DAL_GROWTH_CAPPED))
+        return;
+
+    d->growth = (unsigned char) strategy;
+    size_t log = step > 1 ? log2Floor(step - 1) + 1 : step;
+    d->growthStepLog2 = (unsigned char) MIN(log, sizeof(size_t) * CHAR_BIT - 1);
+}
+
+
+void dal_setAutoShrink(DynarrLO *d, size_t log2) {
+    log2 = log2 ? MIN(MAX(log2, 2), MAX_SHRINK_LOG2) : 0;
+    d->flags = (unsigned char) ((d->flags & ((1 << SHRINK_SHIFT) - 1)) |
+                                log2 << SHRINK_SHIFT);
+}
+
+
+void dal_autoShrink(DynarrLO *d) {
+    size_t log2 = d->flags >> SHRINK_SHIFT;
+
+    // Twice the length, so the array has to lose half of its elements again
+    // or grow by half before it is reallocated once more
+    if (log2 && d->length < d->capacity >> log2 &&
+        !(d->flags & FLAG_BORROWED))
+        setCapacity(d, 2 * d->length);
+}
+
+
+size_t dal_trimIncremental(DynarrLO *d, size_t budget) {
+    size_t target = MAX(d->length, DAL_MIN_CAPACITY);
+    d->error = DAL_OK;
+
+    // Memory of a borrowed buffer can't be released
+    if (d->capacity <= target || (d->flags & FLAG_BORROWED))
+        return 0;
+
+    size_t step = MIN(MAX(budget / d->elemSize, 1), d->capacity - target);
+    d->error = setCapacity(d, d->capacity - step);
+    return itemsToBytes(d, d->capacity - target);
+}
+
+
+void dal_learnCapacity(DalCapacityHint *h, const DynarrLO *d) {
+    h->capacity = MAX(d->length, h->capacity - h->capacity / 8);
+}
+
+
+void dal_stats(const DynarrLO *d, DalStats *stats) {
+#if DAL_STATS
+    *stats = d->stats;
+#else
+    (void) d;
+    *stats = (DalStats) {0};
+#endif
+}
+
+
 void dal_destroyDynarrLO(DynarrLO *d) {
-    d->free(d->array);
+    while (d->slabs) {
+        DalSlab *s = d->slabs;
+        d->slabs = s->prev;
+        d->free(s);
+    }
+
+    if (!(d->flags & FLAG_BORROWED))
+        d->free(allocationOf(d));
+
     *d = (DynarrLO) {0};
 }
 
@@ -114,7 +783,8 @@ void dal_zeroOut(DynarrLO *d,
     d->error = (iStart >= d->capacity) | (iEnd > d->capacity);
     iEnd = MIN(iEnd, d->capacity);
     iStart = MIN(iStart, iEnd);
-    memset(d->array + iStart, 0, itemsToBytes(iEnd - iStart));
+    memset(elemAt(d, iStart), 0, itemsToBytes(d, iEnd - iStart));
+    COUNT_ERROR(d);
 }
 
 
@@ -123,6 +793,12 @@ void dal_setCapacity(DynarrLO *d, size_t capacity) {
 }
 
 
+void dal_reserve(DynarrLO *d, size_t num) {
+    d->error = DAL_OK;
+    growArrayArbitrary(d, num);
+}
+
+
 void dal_shrinkToFit(DynarrLO *d) {
     d->error = setCapacity(d, d->length);
 }
@@ -131,6 +807,8 @@ void dal_shrinkToFit(DynarrLO *d) {
 void dal_setLength(DynarrLO *d, size_t length) {
     d->error = length > d->capacity;
     d->length = MIN(length, d->capacity);
+    COUNT_ERROR(d);
+    COUNT_PEAK(d);
 }
 
 
@@ -142,6 +820,7 @@ void dal_write(DynarrLO *d,
     index = MIN(index, d->capacity);
     d->array[index] = obj;
     d->array[d->capacity] = NULL;
+    COUNT_ERROR(d);
 }
 
 
@@ -150,11 +829,12 @@ void *dal_writeInst(DynarrLO *d,
                     size_t size) {
 
     d->error = index >= d->length;
+    COUNT_ERROR(d);
 
     if (index >= d->capacity)
         return NULL;
 
-    void *obj = d->realloc(NULL, size);
+    void *obj = allocObject(d, size);
 
     if (!obj) {
         d->error = DAL_ALLOCFAIL;
@@ -171,20 +851,91 @@ void dal_append(DynarrLO *d, void *obj) {
 
     d->error = DAL_OK;
     d->array[d->length++] = obj;
+    COUNT(d, appends, 1);
+    COUNT_PEAK(d);
 }
 
 
 void *dal_appendInst(DynarrLO *d, size_t size) {
     d->error = DAL_OK;
-    void *obj = d->realloc(NULL, size);
+    void *obj = allocObject(d, size);
 
     if (!obj || growArray(d)) {
         d->error = DAL_ALLOCFAIL;
-        d->free(obj);
+        freeObject(d, obj);
         return NULL;
     }
 
-    return d->array[d->length++] = obj;
+    COUNT(d, appends, 1);
+    d->array[d->length++] = obj;
+    COUNT_PEAK(d);
+    return obj;
+}
+
+
+void dal_appendMany(DynarrLO *d,
+                    void **objs,
+                    size_t num) {
+
+    void *slots = dal_appendUninit(d, num);
+
+    if (slots)
+        memcpy(slots, objs, itemsToBytes(d, num));
+}
+
+
+void *dal_appendUninit(DynarrLO *d, size_t num) {
+    if (growArrayArbitrary(d, d->length + num))
+        return NULL;
+
+    d->error = DAL_OK;
+    unsigned char *slots = elemAt(d, d->length);
+    d->length += num;
+    COUNT(d, appends, num);
+    COUNT_PEAK(d);
+    return slots;
+}
+
+
+void dal_concat(DynarrLO *dst, DynarrLO *src) {
+    // An array can't be moved into itself
+    if (dst == src) {
+        dst->error = DAL_OUTOFRANGE;
+        COUNT_ERROR(dst);
+        return;
+    }
+
+    src->error = DAL_OK;
+
+    // Nothing to copy if dst may simply take over the array of src. Borrowed
+    // buffers stay with the DynarrLO they were given to.
+    if (!dst->length && dst->realloc == src->realloc &&
+        dst->free == src->free && dst->alignLog2 == src->alignLog2 &&
+        dst->elemSize == src->elemSize &&
+        !((dst->flags | src->flags) & FLAG_BORROWED)) {
+        DynarrLO tmp = *dst;
+        dst->array = src->array;
+        dst->length = src->length;
+        dst->capacity = src->capacity;
+        src->array = tmp.array;
+        src->length = 0;
+        src->capacity = tmp.capacity;
+        dst->error = DAL_OK;
+        COUNT(dst, appends, dst->length);
+        COUNT(src, removes, dst->length);
+        COUNT_PEAK(dst);
+        return;
+    }
+
+    size_t length = src->length;
+    void *slots = dal_appendUninit(dst, length);
+
+    if (!slots)
+        return;
+
+    memcpy(slots, src->array, itemsToBytes(src, length));
+    COUNT(src, removes, length);
+    src->length = 0;
 }
 
 
@@ -194,15 +945,19 @@ void dal_shift(DynarrLO *d,
 
     DAL_ERROR error = index >= d->length;
     d->error = error;
+    COUNT_ERROR(d);
 
     if (error || growArrayArbitrary(d, d->length + shift))
         return;
 
-    memmove(d->array + index + shift,
-            d->array + index,
-            itemsToBytes(d->length - index));
+    memmove(elemAt(d, index + shift),
+            elemAt(d, index),
+            itemsToBytes(d, d->length - index));
 
+    COUNT(d, bytesMoved, itemsToBytes(d, d->length - index));
+    COUNT(d, inserts, shift);
     d->length += shift;
+    COUNT_PEAK(d);
 }
 
 
@@ -212,16 +967,20 @@ void dal_insert(DynarrLO *d,
 
     DAL_ERROR error = index > d->length;
     d->error = error;
+    COUNT_ERROR(d);
 
     if (error || growArray(d))
         return;
 
     memmove(d->array + index + 1,
             d->array + index,
-            itemsToBytes(d->length - index));
+            itemsToBytes(d, d->length - index));
 
     d->array[index] = obj;
+    COUNT(d, bytesMoved, itemsToBytes(d, d->length - index));
+    COUNT(d, inserts, 1);
     ++d->length;
+    COUNT_PEAK(d);
 }
 
 
@@ -232,43 +991,68 @@ void dal_insertMany(DynarrLO *d,
 
     DAL_ERROR error = index > d->length;
     d->error = error;
+    COUNT_ERROR(d);
 
     if (error || growArrayArbitrary(d, d->length + num))
         return;
 
     memmove(d->array + index + num,
             d->array + index,
-            itemsToBytes(d->length - index));
+            itemsToBytes(d, d->length - index));
 
     memmove(d->array + index,
             objs,
-            itemsToBytes(num));
+            itemsToBytes(d, num));
 
+    COUNT(d, bytesMoved, itemsToBytes(d, d->length - index));
+    COUNT(d, inserts, num);
     d->length += num;
+    COUNT_PEAK(d);
 }
 
 
 void *dal_get(DynarrLO *d, size_t index) {
-    d->error = index >= d->length;
+    void *obj = dal_cget(d, index, &d->error);
+    COUNT_ERROR(d);
+    return obj;
+}
+
+
+void *dal_cget(const DynarrLO *d, size_t index, DAL_ERROR *error) {
+    setError(error, index >= d->length);
     index = MIN(index, d->capacity);
     return d->array[index];
 }
 
 
 void *dal_getr(DynarrLO *d, size_t index) {
+    void *obj = dal_cgetr(d, index, &d->error);
+    COUNT_ERROR(d);
+    return obj;
+}
+
+
+void *dal_cgetr(const DynarrLO *d, size_t index, DAL_ERROR *error) {
     index += d->length * (index >= d->capacity);
-    d->error = index >= d->length;
+    setError(error, index >= d->length);
     index = MIN(index, d->capacity);
     return d->array[index];
 }
 
 
 void *dal_getLast(DynarrLO *d) {
+    void *obj = dal_cgetLast(d, &d->error);
+    COUNT_ERROR(d);
+    return obj;
+}
+
+
+void *dal_cgetLast(const DynarrLO *d, DAL_ERROR *error) {
     size_t normlen = d->length - !!d->length;
     void *obj1 = NULL;
     void *obj2 = d->array[normlen];
     void *obj = d->length ? obj2 : obj1;
-    d->error = !d->length;
+    setError(error, !d->length);
     return obj;
 }
 
@@ -279,7 +1063,10 @@ void *dal_pop(DynarrLO *d) {
     void *obj1 = NULL;
     void *obj2 = d->array[normlen];
     void *obj = d->length ? obj2 : obj1;
+    COUNT_ERROR(d);
+    COUNT(d, removes, d->length - normlen);
     d->length = normlen;
+    autoShrink(d);
     return obj;
 }
 
@@ -287,8 +1074,9 @@ void *dal_pop(DynarrLO *d) {
 void dal_freeItem(DynarrLO *d, size_t index) {
     d->error = index >= d->length;
     index = MIN(index, d->capacity);
-    d->free(d->array[index]);
+    freeObject(d, d->array[index]);
     d->array[index] = NULL;
+    COUNT_ERROR(d);
 }
 
 
@@ -298,45 +1086,59 @@ void dal_freeItems(DynarrLO *d,
 
     d->error = (iStart >= d->length) | (iEnd > d->length);
     iEnd = MIN(iEnd, d->capacity);
+    COUNT_ERROR(d);
 
-    for (size_t i = iStart; i < iEnd; ++i) {
-        d->free(d->array[i]);
-        d->array[i] = NULL;
-    }
+    if (iStart < iEnd)
+        freeObjects(d, d->array + iStart, iEnd - iStart);
 }
 
 
 void dal_fremoveLast(DynarrLO *d) {
     d->error = !d->length;
     size_t normlen = d->length - !!d->length;
-    d->free(d->array[normlen]);
+    freeObject(d, d->array[normlen]);
     d->array[normlen] = NULL;
+    COUNT_ERROR(d);
+    COUNT(d, removes, d->length - normlen);
     d->length = normlen;
+    autoShrink(d);
 }
 
 
 void dal_removeLast(DynarrLO *d) {
     d->error = !d->length;
+    COUNT_ERROR(d);
+    COUNT(d, removes, !!d->length);
     d->length -= !!d->length;
+    autoShrink(d);
 }
 
 
 void dal_removeLastMany(DynarrLO *d, size_t amount) {
     d->error = amount > d->length;
     amount = MIN(amount, d->length);
+    COUNT_ERROR(d);
+    COUNT(d, removes, amount);
     d->length -= amount;
+    autoShrink(d);
 }
 
 
 void dal_remove(DynarrLO *d, size_t index) {
-    if ((d->error = index >= d->length))
+    d->error = index >= d->length;
+    COUNT_ERROR(d);
+
+    if (d->error)
         return;
 
-    memmove(d->array + index,
-            d->array + index + 1,
-            itemsToBytes(d->length - (index + 1)));
+    memmove(elemAt(d, index),
+            elemAt(d, index + 1),
+            itemsToBytes(d, d->length - (index + 1)));
 
+    COUNT(d, bytesMoved, itemsToBytes(d, d->length - (index + 1)));
+    COUNT(d, removes, 1);
     --d->length;
+    autoShrink(d);
 }
 
 
@@ -348,11 +1150,180 @@ void dal_removeMany(DynarrLO *d,
     iEnd = MIN(iEnd, d->length);
     iStart = MIN(iStart, iEnd);
 
-    memmove(d->array + iStart,
-            d->array + iEnd,
-            itemsToBytes(d->length - iEnd));
+    memmove(elemAt(d, iStart),
+            elemAt(d, iEnd),
+            itemsToBytes(d, d->length - iEnd));
 
+    COUNT_ERROR(d);
+    COUNT(d, bytesMoved, itemsToBytes(d, d->length - iEnd));
+    COUNT(d, removes, iEnd - iStart);
     d->length -= iEnd - iStart;
+    autoShrink(d);
+}
+
+
+void dal_swrite(DynarrLO *d,
+                size_t index,
+                const void *elem) {
+
+    d->error = index >= d->length;
+    index = MIN(index, d->capacity);
+    memcpy(elemAt(d, index), elem, d->elemSize);
+    memset(elemAt(d, d->capacity), 0, d->elemSize);
+    COUNT_ERROR(d);
+}
+
+
+void *dal_sappend(DynarrLO *d, const void *elem) {
+    size_t offset = offsetIn(d, elem);
+
+    if (growArray(d))
+        return NULL;
+
+    if (offset != SIZE_MAX)
+        elem = bytes(d) + offset;
+
+    d->error = DAL_OK;
+    unsigned char *slot = elemAt(d, d->length++);
+    COUNT(d, appends, 1);
+    COUNT_PEAK(d);
+
+    if (elem)
+        memcpy(slot, elem, d->elemSize);
+    else
+        memset(slot, 0, d->elemSize);
+
+    return slot;
+}
+
+
+void dal_sappendMany(DynarrLO *d,
+                     const void *elems,
+                     size_t num) {
+
+    void *slots = dal_appendUninit(d, num);
+
+    if (slots)
+        memcpy(slots, elems, itemsToBytes(d, num));
+}
+
+
+void *dal_sinsert(DynarrLO *d,
+                  size_t index,
+                  const void *elem) {
+
+    DAL_ERROR error = index > d->length;
+    size_t offset = offsetIn(d, elem);
+    d->error = error;
+    COUNT_ERROR(d);
+
+    if (error || growArray(d))
+        return NULL;
+
+    unsigned char *slot = elemAt(d, index);
+
+    memmove(slot + d->elemSize,
+            slot,
+            itemsToBytes(d, d->length - index));
+
+    // An element of the array at or after index has just moved one slot up
+    if (offset != SIZE_MAX)
+        elem = bytes(d) + offset +
+               (offset >= itemsToBytes(d, index) ? d->elemSize : 0);
+
+    if (elem)
+        memcpy(slot, elem, d->elemSize);
+    else
+        memset(slot, 0, d->elemSize);
+
+    COUNT(d, bytesMoved, itemsToBytes(d, d->length - index));
+    COUNT(d, inserts, 1);
+    ++d->length;
+    COUNT_PEAK(d);
+    return slot;
+}
+
+
+void dal_sinsertMany(DynarrLO *d,
+                     size_t index,
+                     const void *elems,
+                     size_t num) {
+
+    DAL_ERROR error = index > d->length;
+    d->error = error;
+    COUNT_ERROR(d);
+
+    if (error || growArrayArbitrary(d, d->length + num))
+        return;
+
+    memmove(elemAt(d, index + num),
+            elemAt(d, index),
+            itemsToBytes(d, d->length - index));
+
+    memmove(elemAt(d, index),
+            elems,
+            itemsToBytes(d, num));
+
+    COUNT(d, bytesMoved, itemsToBytes(d, d->length - index));
+    COUNT(d, inserts, num);
+    d->length += num;
+    COUNT_PEAK(d);
+}
+
+
+void *dal_sget(DynarrLO *d, size_t index) {
+    void *elem = (void *) dal_csget(d, index, &d->error);
+    COUNT_ERROR(d);
+    return elem;
+}
+
+
+const void *dal_csget(const DynarrLO *d, size_t index, DAL_ERROR *error) {
+    setError(error, index >= d->length);
+    unsigned char *elem = elemAt(d, MIN(index, d->capacity));
+    return index < d->capacity ? elem : NULL;
+}
+
+
+void *dal_sgetr(DynarrLO *d, size_t index) {
+    void *elem = (void *) dal_csgetr(d, index, &d->error);
+    COUNT_ERROR(d);
+    return elem;
+}
+
+
+const void *dal_csgetr(const DynarrLO *d, size_t index, DAL_ERROR *error) {
+    index += d->length * (index >= d->capacity);
+    setError(error, index >= d->length);
+    unsigned char *elem = elemAt(d, MIN(index, d->capacity));
+    return index < d->capacity ? elem : NULL;
+}
+
+
+void *dal_sgetLast(DynarrLO *d) {
+    void *elem = (void *) dal_csgetLast(d, &d->error);
+    COUNT_ERROR(d);
+    return elem;
+}
+
+
+const void *dal_csgetLast(const DynarrLO *d, DAL_ERROR *error) {
+    size_t normlen = d->length - !!d->length;
+    unsigned char *elem = elemAt(d, normlen);
+    setError(error, !d->length);
+    return d->length ? elem : NULL;
+}
+
+
+void *dal_spop(DynarrLO *d) {
+    d->error = !d->length;
+    size_t normlen = d->length - !!d->length;
+    unsigned char *elem = elemAt(d, normlen);
+    elem = d->length ? elem : NULL;
+    COUNT_ERROR(d);
+    COUNT(d, removes, d->length - normlen);
+    d->length = normlen;
+    return elem;
 }
 
 
@@ -367,6 +1338,7 @@ void dal_pwrite(DynarrLO *d,
     index = MIN(index, d->capacity);
     d->arrayp[index] = val;
     d->arrayp[d->capacity] = 0;
+    COUNT_ERROR(d);
 }
 
 
@@ -375,6 +1347,19 @@ void dal_pappend(DynarrLO *d, size_t val) {
         return;
 
     d->arrayp[d->length++] = val;
+    COUNT(d, appends, 1);
+    COUNT_PEAK(d);
+}
+
+
+void dal_pappendMany(DynarrLO *d,
+                     size_t *vals,
+                     size_t num) {
+
+    void *slots = dal_appendUninit(d, num);
+
+    if (slots)
+        memcpy(slots, vals, itemsToBytes(d, num));
 }
 
 
@@ -384,16 +1369,20 @@ void dal_pinsert(DynarrLO *d,
 
     DAL_ERROR error = index > d->length;
     d->error = error;
+    COUNT_ERROR(d);
 
     if (error || growArray(d))
         return;
 
     memmove(d->array + index + 1,
             d->array + index,
-            itemsToBytes(d->length - index));
+            itemsToBytes(d, d->length - index));
 
     d->arrayp[index] = val;
+    COUNT(d, bytesMoved, itemsToBytes(d, d->length - index));
+    COUNT(d, inserts, 1);
     ++d->length;
+    COUNT_PEAK(d);
 }
 
 
@@ -404,43 +1393,68 @@ void dal_pinsertMany(DynarrLO *d,
 
     DAL_ERROR error = index > d->length;
     d->error = error;
+    COUNT_ERROR(d);
 
     if (error || growArrayArbitrary(d, d->length + num))
         return;
 
     memmove(d->array + index + num,
             d->array + index,
-            itemsToBytes(d->length - index));
+            itemsToBytes(d, d->length - index));
 
     memmove(d->array + index,
             vals,
-            itemsToBytes(num));
+            itemsToBytes(d, num));
 
+    COUNT(d, bytesMoved, itemsToBytes(d, d->length - index));
+    COUNT(d, inserts, num);
     d->length += num;
+    COUNT_PEAK(d);
 }
 
 
 size_t dal_pget(DynarrLO *d, size_t index) {
-    d->error = index >= d->length;
+    size_t val = dal_cpget(d, index, &d->error);
+    COUNT_ERROR(d);
+    return val;
+}
+
+
+size_t dal_cpget(const DynarrLO *d, size_t index, DAL_ERROR *error) {
+    setError(error, index >= d->length);
     index = MIN(index, d->capacity);
     return d->arrayp[index];
 }
 
 
 size_t dal_pgetr(DynarrLO *d, size_t index) {
+    size_t val = dal_cpgetr(d, index, &d->error);
+    COUNT_ERROR(d);
+    return val;
+}
+
+
+size_t dal_cpgetr(const DynarrLO *d, size_t index, DAL_ERROR *error) {
     index += d->length * (index >= d->capacity);
-    d->error = index >= d->length;
+    setError(error, index >= d->length);
     index = MIN(index, d->capacity);
     return d->arrayp[index];
 }
 
 
 size_t dal_pgetLast(DynarrLO *d) {
+    size_t val = dal_cpgetLast(d, &d->error);
+    COUNT_ERROR(d);
+    return val;
+}
+
+
+size_t dal_cpgetLast(const DynarrLO *d, DAL_ERROR *error) {
     size_t normlen = d->length - !!d->length;
     size_t val1 = 0;
     size_t val2 = d->arrayp[normlen];
     size_t val = d->length ? val2 : val1;
-    d->error = !d->length;
+    setError(error, !d->length);
     return val;
 }
 
@@ -451,7 +1465,10 @@ size_t dal_ppop(DynarrLO *d) {
     size_t val1 = 0;
     size_t val2 = d->arrayp[normlen];
     size_t val = d->length ? val2 : val1;
+    COUNT_ERROR(d);
+    COUNT(d, removes, d->length - normlen);
     d->length = normlen;
+    autoShrink(d);
     return val;
 }
 
@@ -22,6 +22,63 @@
 #define DAL_PRIMITIVE_SUPPORT (__SIZEOF_SIZE_T__ == __SIZEOF_POINTER__)
 #endif
 
+#ifndef DAL_DEBUG
+/**
+ * If defined as true / 1 before including this header, the unchecked functions
+ * (prefix 'u') assert their preconditions using \p assert() . Otherwise they
+ * perform no checks whatsoever.
+ */
+#define DAL_DEBUG 0
+#endif
+
+#ifndef DAL_HUGEPAGE_SIZE
+/**
+ * Size of a transparent huge page in bytes, see \p dal_useHugePages() .
+ */
+#define DAL_HUGEPAGE_SIZE ((size_t) 2 << 20)
+#endif
+
+#ifndef DAL_STATS
+/**
+ * If defined as true / 1 when compiling the library and all code including
+ * this header, every DynarrLO counts its operations and times its
+ * reallocations, see \p dal_stats() . Otherwise no instrumentation is compiled
+ * at all.
+ */
+#define DAL_STATS 0
+#endif
+
+#ifndef DAL_STATS_BUCKETS
+/**
+ * Number of buckets of the reallocation latency histogram of \p DalStats .
+ */
+#define DAL_STATS_BUCKETS 32
+#endif
+
+#ifndef DAL_GROWTH_STEP
+/**
+ * Default step in bytes of the additive and capped growth strategies, see
+ * \p dal_setGrowth() .
+ */
+#define DAL_GROWTH_STEP ((size_t) 2 << 20)
+#endif
+
+#ifndef DAL_SMALL_CAPACITY
+/**
+ * Capacity of the inline buffer of a \p DalSmallDynarrLO . You may define this
+ * macro yourself when compiling the library. Must not be less than
+ * \p DAL_MIN_CAPACITY .
+ */
+#define DAL_SMALL_CAPACITY 7
+#endif
+
+#if DAL_DEBUG
+#include <assert.h>
+#define DAL_ASSERT(cond) assert(cond)
+#else
+#define DAL_ASSERT(cond) ((void) 0)
+#endif
+
 
 /**
  * DAL_ERROR contains every error code that the error flag of a DynarrLO object
@@ -30,16 +87,18 @@
  * \p DAL_OK           Indicates success\n
  * \p DAL_OUTOFRANGE   Indicates an indexing error\n
  * \p DAL_NULLARG      Indicates an invalid null argument\n
- * \p DAL_ALLOCFAIL    Indicates an error allocating memory\n\n
+ * \p DAL_ALLOCFAIL    Indicates an error allocating memory\n
+ * \p DAL_IOFAIL       Indicates an error accessing a file or an invalid one\n\n
  *
  * Every function that may change the error flag will automatically set it to
  * \p DAL_OK if the function succeeded. The value of DAL_OK is equal to 0,
  * indicating success. Any non-zero value indicates an error.\n\n
  *
  * For every function it applies that nothing will be done if either
- * \p DAL_NULLARG or \p DAL_ALLOCFAIL has occurred. This is in contrast to
- * \p DAL_OUTOFRANGE , where the DynarrLO may still be modified even if it has
- * occurred, so long as no invalid memory accesses are going to be done.\n\n
+ * \p DAL_NULLARG , \p DAL_ALLOCFAIL or \p DAL_IOFAIL has occurred. This is in
+ * contrast to \p DAL_OUTOFRANGE , where the DynarrLO may still be modified even
+ * if it has occurred, so long as no invalid memory accesses are going to be
+ * done.\n\n
  *
  * Imagine a scenario in which a DynarrLO has capacity 10 and length 3. Using
  * \p dal_write() on index 5 would cause \p DAL_OUTOFRANGE to be triggered,
@@ -54,10 +113,90 @@ typedef enum DAL_ERROR {
     DAL_OK,
     DAL_OUTOFRANGE,
     DAL_NULLARG,
-    DAL_ALLOCFAIL
+    DAL_ALLOCFAIL,
+    DAL_IOFAIL
 } DAL_ERROR;
 
 
+/**
+ * DAL_GROWTH contains the strategies by which a DynarrLO grows once it is full,
+ * see \p dal_setGrowth() :\n\n
+ *
+ * \p DAL_GROWTH_HALF      Grows by half of the capacity (default)\n
+ * \p DAL_GROWTH_DOUBLE    Doubles the capacity\n
+ * \p DAL_GROWTH_ADDITIVE  Grows by a fixed step\n
+ * \p DAL_GROWTH_CAPPED    Grows by half of the capacity, at most by a fixed
+ * step, which keeps huge arrays from over-allocating gigabytes
+ */
+typedef enum DAL_GROWTH {
+    DAL_GROWTH_HALF,
+    DAL_GROWTH_DOUBLE,
+    DAL_GROWTH_ADDITIVE,
+    DAL_GROWTH_CAPPED
+} DAL_GROWTH;
+
+
+/**
+ * A slab of the optional object arena of a DynarrLO. Its definition is private
+ * to the implementation.
+ */
+typedef struct DalSlab DalSlab;
+
+
+/**
+ * Operation counters of a DynarrLO, see \p dal_stats() . Elements are counted
+ * individually, e.g. \p dal_appendMany() of 10 elements counts 10 appends.
+ */
+typedef struct DalStats {
+    /**
+     * Appended elements, including those of \p dal_concat() .
+     */
+    size_t appends;
+
+    /**
+     * Inserted elements, including the slots opened by \p dal_shift() .
+     */
+    size_t inserts;
+
+    /**
+     * Removed elements.
+     */
+    size_t removes;
+
+    /**
+     * Reallocations of the array, whether it grew or shrank.
+     */
+    size_t reallocs;
+
+    /**
+     * Bytes of existing elements moved by inserting, removing and shifting.
+     */
+    size_t bytesMoved;
+
+    /**
+     * Operations that set the error flag to \p DAL_OUTOFRANGE .
+     */
+    size_t outOfRange;
+
+    /**
+     * Largest length so far.
+     */
+    size_t peakLength;
+
+    /**
+     * Largest capacity so far.
+     */
+    size_t peakCapacity;
+
+    /**
+     * Bucket k counts the reallocations that took from 2^k up to 2^(k + 1)
+     * nanoseconds. The first bucket also counts faster ones, the last bucket
+     * all slower ones.
+     */
+    size_t latency[DAL_STATS_BUCKETS];
+} DalStats;
+
+
 /**
  * DynarrLO is a dynamic array implementation written in C, conforming to at
  * least the C11 and C17 standards. The only non-C99 feature (that I know of) is
@@ -87,13 +226,15 @@ typedef enum DAL_ERROR {
  * It merely needs a \p realloc() and a \p free() function that conform to the C
  * standard to do its job.\n\n
  *
- * DynarrLO uses a growth factor of 1.5 and does \a not automatically shrink the
- * memory back down if there is slack space at the end of the array. This is
- * done for performance reasons and the fact that in most use cases, that unused
- * space at the end will be used again in the near future, in which case freeing
- * it would fragment memory and cause unnecessary memory operations. If memory
- * should be freed regardless, you may use \p dal_setCapacity() to set the
- * capacity to a value you are comfortable with.\n\n
+ * DynarrLO uses a growth factor of 1.5 by default and does \a not
+ * automatically shrink the memory back down if there is slack space at the end
+ * of the array. This is done for performance reasons and the fact that in most
+ * use cases, that unused space at the end will be used again in the near
+ * future, in which case freeing it would fragment memory and cause unnecessary
+ * memory operations. If memory should be freed regardless, you may use
+ * \p dal_setCapacity() to set the capacity to a value you are comfortable
+ * with, \p dal_trimIncremental() to release it bit by bit or
+ * \p dal_setAutoShrink() to opt in to automatic shrinking.\n\n
  *
  * DynarrLO supports the usage of primitive data types as array elements instead
  * of generic void pointers. This is useful to avoid memory wastage. The type
@@ -109,6 +250,15 @@ typedef enum DAL_ERROR {
  * the unnamed union inside the DynarrLO struct, which breaks C99 conformance.
  * \n\n
  *
+ * DynarrLO can also store elements of an arbitrary fixed size directly inside
+ * its array, which is useful for small structs that would otherwise each need
+ * their own heap allocation. Such a DynarrLO is created with
+ * \p dal_createDynarrLOSized() and its elements are accessed with the sized
+ * functions, which contain an additional \a 's' before the function name.
+ * Functions that do not care about the contents of elements, such as
+ * \p dal_setLength() , \p dal_remove() or \p dal_shift() , work for every
+ * element size.\n\n
+ *
  * DynarrLO only works with a few very basic functions of the C standard library
  * and with nothing else. The source file includes stdbool.h and string.h.
  * Additionally, the header includes stddef.h.\n\n
@@ -152,11 +302,38 @@ typedef struct DynarrLO {
      */
     size_t capacity;
 
+    /**
+     * Size of a single element in bytes.
+     */
+    size_t elemSize;
+
     /**
      * Error flag.
      */
     DAL_ERROR error;
 
+    /**
+     * Base 2 logarithm of the alignment of the array or 0 if the alignment
+     * guaranteed by \p realloc() suffices.
+     */
+    unsigned char alignLog2;
+
+    /**
+     * Allocation flags, private to the implementation.
+     */
+    unsigned char flags;
+
+    /**
+     * Growth strategy, see \p DAL_GROWTH .
+     */
+    unsigned char growth;
+
+    /**
+     * Base 2 logarithm of the step of the growth strategy in bytes or 0 for
+     * \p DAL_GROWTH_STEP .
+     */
+    unsigned char growthStepLog2;
+
     /**
      * A \p realloc() function conforming to the C standard.
      */
@@ -166,16 +343,63 @@ typedef struct DynarrLO {
      * A \p free() function conforming to the C standard.
      */
     void  (*free)    (void *ptr);
+
+    /**
+     * Newest slab of the object arena or NULL if objects are allocated
+     * individually.
+     */
+    DalSlab *slabs;
+
+#if DAL_STATS
+    /**
+     * Operation counters.
+     */
+    DalStats stats;
+#endif
 } DynarrLO;
 
 
+/**
+ * A DynarrLO of pointers or primitive values that starts out with an inline
+ * buffer of \p DAL_SMALL_CAPACITY elements instead of a heap allocation. Create
+ * it with \p dal_createSmall() and pass \p &s->d to the DynarrLO functions.
+ * The array moves to the heap once it outgrows the buffer. As \p d points into
+ * the struct until then, the struct must not be moved or copied.
+ */
+typedef struct DalSmallDynarrLO {
+    /**
+     * The DynarrLO itself.
+     */
+    DynarrLO d;
+
+    /**
+     * Inline buffer, including the padding element.
+     */
+    void *buffer[DAL_SMALL_CAPACITY + 1];
+} DalSmallDynarrLO;
+
+
+/**
+ * A starting capacity learned from the lengths that earlier arrays of the same
+ * kind reached, e.g. the arrays created at one place in the code. Initialise
+ * it with {0}, create arrays with the capacity of \p dal_hintCapacity() and
+ * report their final lengths with \p dal_learnCapacity() .
+ */
+typedef struct DalCapacityHint {
+    /**
+     * Learned capacity.
+     */
+    size_t capacity;
+} DalCapacityHint;
+
+
 
 /**
  * Simple accessor function to retrieve the length of a DynarrLO object.\n\n
  * This function is declared \p static \p inline .
  * @return Current amount of elements in this DynarrLO.
  */
-static inline size_t dal_len(DynarrLO *d) {
+static inline size_t dal_len(const DynarrLO *d) {
     return d->length;
 }
 
@@ -185,7 +409,7 @@ static inline size_t dal_len(DynarrLO *d) {
  * This function is declared \p static \p inline .
  * @return Allocated memory for DynarrLO array in elements.
  */
-static inline size_t dal_cap(DynarrLO *d) {
+static inline size_t dal_cap(const DynarrLO *d) {
     return d->capacity;
 }
 
@@ -196,7 +420,7 @@ static inline size_t dal_cap(DynarrLO *d) {
  * This function is declared \p static \p inline .
  * @return Error flag value.
  */
-static inline DAL_ERROR dal_err(DynarrLO *d) {
+static inline DAL_ERROR dal_err(const DynarrLO *d) {
     return d->error;
 }
 
@@ -218,9 +442,283 @@ DAL_ERROR dal_createDynarrLO(DynarrLO *d,
 
 
 /**
- * Frees its array and sets all struct fields of this DynarrLO to 0. Elements
- * residing in the array are not automatically freed. This needs to be done
- * manually beforehand.
+ * Tries to create and allocate a dynamic array whose elements are \p elemSize
+ * bytes large and stored inline in the array. Use the sized functions (prefix
+ * \a 's') to access elements of such a DynarrLO. Does nothing on failure.
+ * @param d Pointer to DynarrLO object that shall be initialised.
+ * @param capacity Desired starting capacity.
+ * @param elemSize Size of a single element in bytes.
+ * @param realloc realloc function conforming to the C standard.
+ * @param free free function conforming to the C standard.
+ * @return Error code indicating either success \p(DAL_OK), a null argument
+ * error \p(DAL_NULLARG) if any pointer or \p elemSize is 0 or failure to
+ * allocate the requested amount of memory \p (DAL_ALLOCFAIL) .
+ */
+DAL_ERROR dal_createDynarrLOSized(DynarrLO *d,
+                                  size_t capacity,
+                                  size_t elemSize,
+                                  void *(*realloc) (void *, size_t),
+                                  void (*free) (void *));
+
+
+/**
+ * Tries to create and allocate a dynamic array like
+ * \p dal_createDynarrLOSized() whose array starts at an address that is a
+ * multiple of \p alignment , e.g. 64 so that every cache line and every AVX
+ * vector of the array lines up. The alignment is kept whenever the array is
+ * reallocated. The padding element behaves just like in any other DynarrLO.\n\n
+ *
+ * To get there, the array is over-allocated by \p alignment bytes with the
+ * provided \p realloc() function. If growing it in place is not possible,
+ * \p realloc() may return memory with a different alignment, in which case the
+ * array is moved within the new allocation once more. Alignments no larger
+ * than \p _Alignof(max_align_t) cost nothing, as \p realloc() already
+ * guarantees those.
+ * @param d Pointer to DynarrLO object that shall be initialised.
+ * @param capacity Desired starting capacity.
+ * @param elemSize Size of a single element in bytes.
+ * @param alignment Alignment of the array in bytes. Rounded up to the next
+ * power of two.
+ * @param realloc realloc function conforming to the C standard.
+ * @param free free function conforming to the C standard.
+ * @return Error code indicating either success \p(DAL_OK), a null argument
+ * error \p(DAL_NULLARG) if any pointer or \p elemSize is 0 or failure to
+ * allocate the requested amount of memory \p (DAL_ALLOCFAIL) .
+ */
+DAL_ERROR dal_createDynarrLOAligned(DynarrLO *d,
+                                   size_t capacity,
+                                   size_t elemSize,
+                                   size_t alignment,
+                                   void *(*realloc) (void *, size_t),
+                                   void (*free) (void *));
+
+
+/**
+ * Creates a DynarrLO that uses caller-provided memory, e.g. a stack or static
+ * buffer, as its array, so creating it allocates nothing. The last element of
+ * the buffer becomes the padding element. Once the array needs to grow, it is
+ * copied into memory allocated with \p realloc() and behaves like any other
+ * DynarrLO from then on. The buffer is never passed to \p realloc() or
+ * \p free() , and it is neither freed nor modified after the array has left
+ * it. Reducing the capacity keeps the array in the buffer.\n\n
+ *
+ * The buffer must be suitably aligned for the elements and outlive the
+ * DynarrLO or its growth beyond the buffer. Do not pass the DynarrLO to
+ * functions of other modules that take over its array, such as
+ * \p dal_mmapReserve() , while it resides in the buffer.
+ * @param d Pointer to DynarrLO object that shall be initialised.
+ * @param buffer Memory for the array.
+ * @param size Size of \p buffer in bytes.
+ * @param elemSize Size of a single element in bytes. Use \p sizeof(void *) for
+ * pointer and primitive arrays.
+ * @param realloc realloc function conforming to the C standard.
+ * @param free free function conforming to the C standard.
+ * @return Error code indicating either success \p(DAL_OK), a null argument
+ * error \p(DAL_NULLARG) if any pointer or \p elemSize is 0 or a buffer too
+ * small for \p DAL_MIN_CAPACITY elements and the padding element
+ * \p (DAL_OUTOFRANGE) .
+ */
+DAL_ERROR dal_createFromBuffer(DynarrLO *d,
+                               void *buffer,
+                               size_t size,
+                               size_t elemSize,
+                               void *(*realloc) (void *, size_t),
+                               void (*free) (void *));
+
+
+/**
+ * Creates the DynarrLO \p s->d of pointers or primitive values in the inline
+ * buffer of \p s with \p dal_createFromBuffer() . Allocates nothing.
+ * @param s Pointer to small DynarrLO object that shall be initialised.
+ * @param realloc realloc function conforming to the C standard.
+ * @param free free function conforming to the C standard.
+ * @return Error code indicating either success \p(DAL_OK) or a null argument
+ * error \p(DAL_NULLARG) .
+ */
+DAL_ERROR dal_createSmall(DalSmallDynarrLO *s,
+                          void *(*realloc) (void *, size_t),
+                          void (*free) (void *));
+
+
+/**
+ * Tries to create a DynarrLO that is a copy of \p src . The copy has the same
+ * element size, alignment, allocation functions, growth strategy and huge page
+ * setting and a capacity equal to the length of \p src . Only the elements are
+ * copied, not the objects they may point to, and the object arena is not
+ * shared. Does nothing on failure.\n\n
+ *
+ * Copying takes time proportional to the length of \p src . Use a segmented
+ * array (see \p dal_segClone() ) for copy-on-write snapshots.
+ * @param dst Pointer to DynarrLO object that shall be initialised.
+ * @param src DynarrLO to copy, which is not modified.
+ * @return Error code indicating either success \p(DAL_OK), a null argument
+ * error \p(DAL_NULLARG) or failure to allocate the requested amount of memory
+ * \p (DAL_ALLOCFAIL) .
+ */
+DAL_ERROR dal_clone(DynarrLO *dst, const DynarrLO *src);
+
+
+/**
+ * Asks the operating system to back the array with transparent huge pages
+ * using \p madvise(MADV_HUGEPAGE) , which reduces TLB misses of random
+ * accesses to large arrays. Applies to the current array and to every
+ * reallocation of it from now on. Only the 2 MiB aligned parts of the array
+ * can be backed by huge pages, so create the DynarrLO with
+ * \p dal_createDynarrLOAligned() and an alignment of \p DAL_HUGEPAGE_SIZE if
+ * the array is only a few huge pages large.\n\n
+ *
+ * Only has an effect on Linux. Arrays smaller than \p DAL_HUGEPAGE_SIZE are
+ * never advised.
+ */
+void dal_useHugePages(DynarrLO *d);
+
+
+/**
+ * Makes this DynarrLO allocate all further objects of \p dal_appendInst() and
+ * \p dal_writeInst() from an object arena instead of calling \p realloc()
+ * once per object. The arena consists of slabs, the first of which has
+ * \p slabSize bytes. Every further slab is 1.5 times the size of the previous
+ * one. Objects are placed next to each other in allocation order, so objects
+ * that are appended one after the other also lie in index order in memory.
+ * \n\n
+ *
+ * \p dal_freeItem() , \p dal_freeItems() and \p dal_fremoveLast() hand
+ * objects of the arena back to their slab. A slab is released with a single
+ * call to \p free() as soon as all of its objects have been freed, and the
+ * most recently allocated object is reused immediately after being freed.
+ * Finding the slab of an object costs nothing for recently allocated objects
+ * and for ranges of objects that were appended in order.
+ * Objects that were not allocated from the arena are still passed to
+ * \p free() individually. \p dal_destroyDynarrLO() releases the arena and
+ * thereby every object allocated from it at once.\n\n
+ *
+ * Does nothing if the arena is already in use. Sets error flag to
+ * \p DAL_ALLOCFAIL if the first slab couldn't be allocated.
+ * @param slabSize Size of the first slab in bytes.
+ */
+void dal_useArena(DynarrLO *d, size_t slabSize);
+
+
+/**
+ * Selects the strategy by which this DynarrLO grows once it is full. Whatever
+ * the strategy, the grown capacity is rounded up so that the allocation,
+ * including the padding element, fills the size class the allocator serves it
+ * from: multiples of 16 bytes for small arrays, four classes per power of two
+ * for medium ones and whole pages for large ones. If the array is allocated
+ * with the standard \p realloc() of glibc, any further slack reported by
+ * \p malloc_usable_size() is added to the capacity as well.\n\n
+ *
+ * Only growth is affected. \p dal_createDynarrLO() , \p dal_setCapacity()
+ * and \p dal_shrinkToFit() set the capacity exactly as requested.
+ * Sets error flag to \p DAL_OUTOFRANGE if \p strategy is invalid, in which
+ * case nothing is done.
+ * @param strategy Growth strategy, see \p DAL_GROWTH .
+ * @param step Step of \p DAL_GROWTH_ADDITIVE and \p DAL_GROWTH_CAPPED in
+ * bytes, rounded up to the next power of two, or 0 for \p DAL_GROWTH_STEP .
+ * Always at least one element.
+ */
+void dal_setGrowth(DynarrLO *d, DAL_GROWTH strategy, size_t step);
+
+
+/**
+ * Makes this DynarrLO shrink automatically once its length falls below
+ * capacity / 2^ \p log2 after removing elements. The capacity is then set to
+ * twice the length, so an array that hovers around a boundary is not
+ * reallocated on every insertion and removal. Applies to all removals,
+ * including \p dal_pop() , \p dal_removeLast() , \p dal_removeLastMany() and
+ * their primitive and typed versions, which invalidate pointers into the array
+ * if shrinking is enabled. Arrays that don't opt in pay a single branch per
+ * removal. \p dal_spop() never shrinks, as the pointer it returns would
+ * dangle. A failed shrink leaves the array and its error flag as they are.
+ * Arrays in a buffer passed to \p dal_createFromBuffer() never shrink.
+ * @param log2 Base 2 logarithm of the threshold fraction, e.g. 2 to shrink
+ * below a quarter of the capacity. Values below 2 are treated as 2, values
+ * above 15 as 15. 0 disables shrinking, which is the default.
+ */
+void dal_setAutoShrink(DynarrLO *d, size_t log2);
+
+
+/**
+ * Bits of the flags of a DynarrLO from this one up hold the threshold of
+ * \p dal_setAutoShrink() . Private to the implementation.
+ */
+#define DAL_SHRINK_SHIFT 4
+
+
+/**
+ * Checks whether automatic shrinking is enabled for this DynarrLO, see
+ * \p dal_setAutoShrink() .\n\n
+ * This function is declared \p static \p inline .
+ * @return Non-zero iff the DynarrLO shrinks automatically.
+ */
+static inline int dal_autoShrinks(const DynarrLO *d) {
+    return d->flags >> DAL_SHRINK_SHIFT;
+}
+
+
+/**
+ * Shrinks the array as \p dal_setAutoShrink() describes if shrinking is
+ * enabled and the length has fallen below the threshold. The removing
+ * functions do this on their own. It is meant for inline code like
+ * \p DAL_DEFINE() that removes elements without calling them.
+ */
+void dal_autoShrink(DynarrLO *d);
+
+
+/**
+ * Releases at most \p budget bytes of the slack at the end of the array, so
+ * that a maintenance loop can trim arrays bit by bit without long pauses.
+ * Repeated calls shrink the capacity down to the length. Each call reallocates
+ * the array once, which allocators like glibc's and \p dal_mmapRealloc() do in
+ * place when shrinking, making its cost proportional to \p budget .
+ * Sets error flag to \p DAL_ALLOCFAIL if memory couldn't be allocated. The
+ * function does nothing in this case.
+ * @param budget Maximum number of bytes to release. At least one element is
+ * released if there is any slack.
+ * @return Number of bytes of slack left to release, 0 once done.
+ */
+size_t dal_trimIncremental(DynarrLO *d, size_t budget);
+
+
+/**
+ * Gets the capacity to create an array with, as learned by
+ * \p dal_learnCapacity() .\n\n
+ * This function is declared \p static \p inline .
+ * @return Learned capacity, 0 if nothing has been learned yet.
+ */
+static inline size_t dal_hintCapacity(const DalCapacityHint *h) {
+    return h->capacity;
+}
+
+
+/**
+ * Learns from the current length of a DynarrLO, typically right before it is
+ * destroyed. The hint follows an increase at once and decreases by an eighth
+ * per array, so a single large array is forgotten soon while a steady length
+ * is reserved from the start and never needs to grow. Not thread safe.
+ * @param h Hint to update.
+ * @param d DynarrLO whose length is learned.
+ */
+void dal_learnCapacity(DalCapacityHint *h, const DynarrLO *d);
+
+
+/**
+ * Copies the operation counters of this DynarrLO. Counting is only compiled if
+ * \p DAL_STATS is true, otherwise all counters are 0. The functions generated
+ * by \p DAL_DEFINE() are counted as well, as long as they are compiled with
+ * the same \p DAL_STATS . The read-only 'c' functions and the unchecked 'u'
+ * functions are not counted.
+ * @param stats Receives the counters.
+ */
+void dal_stats(const DynarrLO *d, DalStats *stats);
+
+
+/**
+ * Frees its array, unless the array still resides in a buffer passed to
+ * \p dal_createFromBuffer() , and sets all struct fields of this DynarrLO to
+ * 0. Elements residing in the array are not automatically freed. This needs to
+ * be done manually beforehand, unless they were allocated from the object
+ * arena, which is released as a whole.
  */
 void dal_destroyDynarrLO(DynarrLO *d);
 
@@ -250,6 +748,17 @@ void dal_zeroOut(DynarrLO *d,
 void dal_setCapacity(DynarrLO *d, size_t capacity);
 
 
+/**
+ * Grows the array if necessary so it can hold at least \p num elements. If it
+ * grows, it grows by at least the usual growth factor. Never shrinks the array.
+ *
+ * Sets error flag to \p DAL_ALLOCFAIL if memory couldn't be allocated. The
+ * function does nothing in this case.
+ * @param num Number of elements the array must be able to hold.
+ */
+void dal_reserve(DynarrLO *d, size_t num);
+
+
 /**
  * Unconditionally sets the capacity equal to the length of this DynarrLO,
  * cutting off excess elements if \p capacity subceeds the current capacity.
@@ -313,6 +822,59 @@ void dal_append(DynarrLO *d, void *obj);
 void *dal_appendInst(DynarrLO *d, size_t size);
 
 
+/**
+ * Appends many objects to the back of the array at once. Grows the array at
+ * most once. Avoid using the DynarrLO's internal array as the array of objects
+ * to append.\n\n
+ *
+ * It is the caller's responsibility to ensure that all memory accesses to the
+ * provided array up to index ( \p num - \p 1) do not cause undefined behaviour.
+ * \n\n
+ *
+ * Error flag is set to \p DAL_ALLOCFAIL if memory couldn't be allocated.
+ * @param objs Array of objects to append.
+ * @param num Number of objects to append.
+ */
+void dal_appendMany(DynarrLO *d,
+                    void **objs,
+                    size_t num);
+
+
+/**
+ * Appends \p num uninitialised elements to the back of the array and returns
+ * a pointer to the first of them, so that they can be filled in directly, e.g.
+ * by \p read() or a decoder, without an intermediate buffer. Grows the array
+ * at most once. Works for every element size. If fewer elements end up being
+ * written, remove the rest with \p dal_removeLastMany() .\n\n
+ *
+ * Error flag is set to \p DAL_ALLOCFAIL if memory couldn't be allocated, in
+ * which case nothing is appended.
+ * @param num Number of elements to append.
+ * @return Pointer to the first appended element or NULL on failure. The
+ * pointer is valid until the capacity of the array changes.
+ */
+void *dal_appendUninit(DynarrLO *d, size_t num);
+
+
+/**
+ * Moves all elements of \p src to the back of \p dst , leaving \p src empty.
+ * Both must have the same element size. If \p dst is empty, both use the
+ * same \p realloc() and \p free() functions and alignment and neither array
+ * resides in a buffer passed to \p dal_createFromBuffer() , their arrays are
+ * simply swapped and no element is copied.\n\n
+ *
+ * Objects of \p src allocated from its object arena remain owned by that
+ * arena.\n\n
+ *
+ * Error flag of \p dst is set to \p DAL_OUTOFRANGE if \p dst and \p src are
+ * the same DynarrLO or to \p DAL_ALLOCFAIL if memory couldn't be allocated.
+ * Apart from that error flag, neither DynarrLO is modified then.
+ * @param dst DynarrLO to append to.
+ * @param src DynarrLO whose elements are moved.
+ */
+void dal_concat(DynarrLO *dst, DynarrLO *src);
+
+
 /**
  * Shifts all elements starting at index to the right by the amount given by
  * shift. The length is also increased by that amount. This function acts like
@@ -380,6 +942,17 @@ void dal_insertMany(DynarrLO *d,
 void *dal_get(DynarrLO *d, size_t index);
 
 
+/**
+ * Read-only version of \p dal_get() that never writes to the DynarrLO object,
+ * so any number of threads may call it on the same array at once.
+ * @param index Index to access.
+ * @param error Receives \p DAL_OUTOFRANGE if \p index >= length or \p DAL_OK
+ * otherwise. May be NULL.
+ * @return Element at \p index or NULL if \p index >= capacity.
+ */
+void *dal_cget(const DynarrLO *d, size_t index, DAL_ERROR *error);
+
+
 /**
  * Gets the element at \p index. \p index may be negative, in which case -1 is
  * the last element, -2 the penultimate one, etc. The index is converted to a
@@ -393,6 +966,16 @@ void *dal_get(DynarrLO *d, size_t index);
 void *dal_getr(DynarrLO *d, size_t index);
 
 
+/**
+ * Read-only version of \p dal_getr() , see \p dal_cget() .
+ * @param index Index to access, may be negative.
+ * @param error Receives the error code. May be NULL.
+ * @return Element at \p index after possibly converting \p index to a positive
+ * value first. NULL if resulting \p index >= capacity.
+ */
+void *dal_cgetr(const DynarrLO *d, size_t index, DAL_ERROR *error);
+
+
 /**
  * Gets the hindmost element and returns it without removing it from the array.
  * Error flag is set to \p DAL_OUTOFRANGE if array is empty.
@@ -401,6 +984,14 @@ void *dal_getr(DynarrLO *d, size_t index);
 void *dal_getLast(DynarrLO *d);
 
 
+/**
+ * Read-only version of \p dal_getLast() , see \p dal_cget() .
+ * @param error Receives the error code. May be NULL.
+ * @return Hindmost element or NULL if array is empty.
+ */
+void *dal_cgetLast(const DynarrLO *d, DAL_ERROR *error);
+
+
 /**
  * Removes the hindmost element and returns it. Error flag is set to
  * \p DAL_OUTOFRANGE if array is empty.
@@ -479,6 +1070,146 @@ void dal_removeMany(DynarrLO *d,
                     size_t iEnd);
 
 
+/**
+ * Copies an element of the array's element size into the array. Does nothing
+ * if \p index >= capacity. Sets error flag to \p DAL_OUTOFRANGE if \p index >=
+ * length.
+ * @param index Index to overwrite.
+ * @param elem Pointer to the element that shall be copied to the \p index.
+ */
+void dal_swrite(DynarrLO *d,
+                size_t index,
+                const void *elem);
+
+
+/**
+ * Copies an element to the back of the array. Grows the array if needed. Error
+ * flag is set to \p DAL_ALLOCFAIL if memory couldn't be allocated.
+ * @param elem Pointer to the element to append. If NULL, the appended element
+ * is zero-initialised instead. May point to an element of this DynarrLO, which
+ * is tracked if the array grows. Any other part of the internal array must not
+ * be used as the source.
+ * @return Pointer to the appended element inside the array if successful. NULL
+ * on failure. The pointer is valid until the array is modified next.
+ */
+void *dal_sappend(DynarrLO *d, const void *elem);
+
+
+/**
+ * Copies many elements to the back of the array at once. Grows the array if
+ * needed. Avoid using the DynarrLO's internal array as the source.\n\n
+ *
+ * Error flag is set to \p DAL_ALLOCFAIL if memory couldn't be allocated.
+ * @param elems Contiguous elements to append.
+ * @param num Number of elements to append.
+ */
+void dal_sappendMany(DynarrLO *d,
+                     const void *elems,
+                     size_t num);
+
+
+/**
+ * Inserts a copy of an element at \p index shifting all elements starting at
+ * \p index one to the right before doing so. Grows array if needed. If
+ * \p index == length, behaviour is identical to \p dal_sappend().
+ *
+ * Error flag is set to \p DAL_OUTOFRANGE if \p index > length or to
+ * \p DAL_ALLOCFAIL if memory couldn't be allocated.
+ * @param index Index element should assume.
+ * @param elem Pointer to the element to insert. If NULL, the inserted element
+ * is zero-initialised instead. May point to an element of this DynarrLO, which
+ * is tracked if the array grows or the element is shifted. Any other part of
+ * the internal array must not be used as the source.
+ * @return Pointer to the inserted element inside the array if successful. NULL
+ * on failure. The pointer is valid until the array is modified next.
+ */
+void *dal_sinsert(DynarrLO *d,
+                  size_t index,
+                  const void *elem);
+
+
+/**
+ * Same as \p dal_sinsert() , but inserts many elements at once, thereby
+ * shifting elements starting at \p index by \p num to the right. Avoid using
+ * the DynarrLO's internal array as the source.\n\n
+ *
+ * Error flag is set to \p DAL_OUTOFRANGE if \p index > length or to
+ * \p DAL_ALLOCFAIL if memory couldn't be allocated.
+ * @param index Index first element should assume.
+ * @param elems Contiguous elements to insert.
+ * @param num Number of elements to insert.
+ */
+void dal_sinsertMany(DynarrLO *d,
+                     size_t index,
+                     const void *elems,
+                     size_t num);
+
+
+/**
+ * Gets a pointer to the element at \p index. Error flag is set to
+ * \p DAL_OUTOFRANGE if \p index >= length.
+ * @param index Index to access.
+ * @return Pointer to element at \p index or NULL if \p index >= capacity. The
+ * pointer is valid until the capacity of the array changes.
+ */
+void *dal_sget(DynarrLO *d, size_t index);
+
+
+/**
+ * Read-only version of \p dal_sget() , see \p dal_cget() .
+ * @param index Index to access.
+ * @param error Receives the error code. May be NULL.
+ * @return Pointer to element at \p index or NULL if \p index >= capacity.
+ */
+const void *dal_csget(const DynarrLO *d, size_t index, DAL_ERROR *error);
+
+
+/**
+ * Gets a pointer to the element at \p index. \p index may be negative, in
+ * which case -1 is the last element, -2 the penultimate one, etc. See
+ * \p dal_getr() .
+ * @param index Index to access, may be negative.
+ * @return Pointer to element at \p index after possibly converting \p index
+ * to a positive value first. NULL if resulting \p index >= capacity.
+ */
+void *dal_sgetr(DynarrLO *d, size_t index);
+
+
+/**
+ * Read-only version of \p dal_sgetr() , see \p dal_cget() .
+ * @param index Index to access, may be negative.
+ * @param error Receives the error code. May be NULL.
+ * @return Pointer to element at \p index after possibly converting \p index
+ * to a positive value first. NULL if resulting \p index >= capacity.
+ */
+const void *dal_csgetr(const DynarrLO *d, size_t index, DAL_ERROR *error);
+
+
+/**
+ * Gets a pointer to the hindmost element without removing it from the array.
+ * Error flag is set to \p DAL_OUTOFRANGE if array is empty.
+ * @return Pointer to hindmost element or NULL if array is empty.
+ */
+void *dal_sgetLast(DynarrLO *d);
+
+
+/**
+ * Read-only version of \p dal_sgetLast() , see \p dal_cget() .
+ * @param error Receives the error code. May be NULL.
+ * @return Pointer to hindmost element or NULL if array is empty.
+ */
+const void *dal_csgetLast(const DynarrLO *d, DAL_ERROR *error);
+
+
+/**
+ * Removes the hindmost element and returns a pointer to it. The element stays
+ * in place until it is overwritten by the next modification of the array.
+ * Error flag is set to \p DAL_OUTOFRANGE if array is empty.
+ * @return Pointer to the removed element or NULL if array was empty.
+ */
+void *dal_spop(DynarrLO *d);
+
+
 #if DAL_PRIMITIVE_SUPPORT
 
 /**
@@ -500,6 +1231,24 @@ void dal_pwrite(DynarrLO *d,
 void dal_pappend(DynarrLO *d, size_t val);
 
 
+/**
+ * Appends many values to the back of the array at once. Grows the array at
+ * most once. Avoid using the DynarrLO's internal array as the array of values
+ * to append.\n\n
+ *
+ * It is the caller's responsibility to ensure that all memory accesses to the
+ * provided array up to index ( \p num - \p 1) do not cause undefined behaviour.
+ * \n\n
+ *
+ * Error flag is set to \p DAL_ALLOCFAIL if memory couldn't be allocated.
+ * @param vals Array of values to append.
+ * @param num Number of values to append.
+ */
+void dal_pappendMany(DynarrLO *d,
+                     size_t *vals,
+                     size_t num);
+
+
 /**
  * Inserts an element at \p index shifting all elements starting at \p index
  * one to the right before doing so. Grows array if needed. If \p index ==
@@ -546,6 +1295,15 @@ void dal_pinsertMany(DynarrLO *d,
 size_t dal_pget(DynarrLO *d, size_t index);
 
 
+/**
+ * Primitive version of \p dal_cget() .
+ * @param index Index to access.
+ * @param error Receives the error code. May be NULL.
+ * @return Element at \p index or 0 if \p index >= capacity.
+ */
+size_t dal_cpget(const DynarrLO *d, size_t index, DAL_ERROR *error);
+
+
 /**
  * Gets the element at \p index. \p index may be negative, in which case -1 is
  * the last element, -2 the penultimate one, etc. The index is converted to a
@@ -559,6 +1317,16 @@ size_t dal_pget(DynarrLO *d, size_t index);
 size_t dal_pgetr(DynarrLO *d, size_t index);
 
 
+/**
+ * Primitive version of \p dal_cgetr() .
+ * @param index Index to access, may be negative.
+ * @param error Receives the error code. May be NULL.
+ * @return Element at \p index after possibly converting \p index to a positive
+ * value first. 0 if resulting \p index >= capacity.
+ */
+size_t dal_cpgetr(const DynarrLO *d, size_t index, DAL_ERROR *error);
+
+
 /**
  * Gets the hindmost element and returns it without removing it from the array.
  * Error flag is set to \p DAL_OUTOFRANGE if array is empty.
@@ -567,6 +1335,14 @@ size_t dal_pgetr(DynarrLO *d, size_t index);
 size_t dal_pgetLast(DynarrLO *d);
 
 
+/**
+ * Primitive version of \p dal_cgetLast() .
+ * @param error Receives the error code. May be NULL.
+ * @return Hindmost element or 0 if array is empty.
+ */
+size_t dal_cpgetLast(const DynarrLO *d, DAL_ERROR *error);
+
+
 /**
  * Removes the hindmost element and returns it. Error flag is set to
  * \p DAL_OUTOFRANGE if array is empty.
@@ -575,4 +1351,166 @@ size_t dal_pgetLast(DynarrLO *d);
 size_t dal_ppop(DynarrLO *d);
 
 #endif // DAL_PRIMITIVE_SUPPORT
+
+
+
+/**
+ * A contiguous range of elements inside the array of a DynarrLO.
+ */
+typedef struct DalSpan {
+    /**
+     * First element of the range. Cast it to the element type of the DynarrLO,
+     * e.g. \p void** , \p size_t* or a pointer to a sized element type.
+     */
+    void *data;
+
+    /**
+     * Number of elements in the range.
+     */
+    size_t length;
+} DalSpan;
+
+
+/**
+ * Gets the contiguous range of all elements of this DynarrLO, so that loops
+ * can run over a plain pointer. The span is valid until the capacity of the
+ * array changes.\n\n
+ * This function is declared \p static \p inline .
+ * @return Span of the elements [0, length).
+ */
+static inline DalSpan dal_data(const DynarrLO *d) {
+    return (DalSpan) {d->array, d->length};
+}
+
+
+/**
+ * Read-only version of \p dal_span() , see \p dal_cget() .\n\n
+ * This function is declared \p static \p inline .
+ * @param begin Index of the first element (inclusive). Automatically set to
+ * the final value of \p end if it exceeds the final value of \p end.
+ * @param end Index after the last element (exclusive). Automatically set to
+ * length if it exceeds the value of length.
+ * @param error Receives \p DAL_OUTOFRANGE if \p begin > length or
+ * \p end > length and \p DAL_OK otherwise. May be NULL.
+ * @return Span of the elements [begin, end).
+ */
+static inline DalSpan dal_cspan(const DynarrLO *d,
+                                size_t begin,
+                                size_t end,
+                                DAL_ERROR *error) {
+
+    if (error)
+        *error = (begin > d->length) | (end > d->length);
+
+    end = end < d->length ? end : d->length;
+    begin = begin < end ? begin : end;
+    unsigned char *data = (unsigned char *) d->array + begin * d->elemSize;
+    return (DalSpan) {data, end - begin};
+}
+
+
+/**
+ * Gets a contiguous range of elements of this DynarrLO. The span is valid until
+ * the capacity of the array changes. Error flag is set to \p DAL_OUTOFRANGE if
+ * \p begin > length or \p end > length.\n\n
+ * This function is declared \p static \p inline .
+ * @param begin Index of the first element (inclusive). Automatically set to
+ * the final value of \p end if it exceeds the final value of \p end.
+ * @param end Index after the last element (exclusive). Automatically set to
+ * length if it exceeds the value of length.
+ * @return Span of the elements [begin, end).
+ */
+static inline DalSpan dal_span(DynarrLO *d, size_t begin, size_t end) {
+    return dal_cspan(d, begin, end, &d->error);
+}
+
+
+/*
+ * The unchecked functions below (prefix 'u') do neither clamp indices, nor
+ * write the error flag, nor touch the padding element. Calling them with an
+ * index outside of [0, length) is undefined behaviour. They are meant for hot
+ * loops whose bounds are already known to be valid. Define DAL_DEBUG as 1 to
+ * turn their preconditions into assertions for testing.
+ */
+
+
+/**
+ * Gets the element at \p index without any checks. \p index must be less
+ * than length.\n\n
+ * This function is declared \p static \p inline .
+ */
+static inline void *dal_uget(const DynarrLO *d, size_t index) {
+    DAL_ASSERT(index < d->length);
+    return d->array[index];
+}
+
+
+/**
+ * Writes an object at \p index without any checks. \p index must be less
+ * than length.\n\n
+ * This function is declared \p static \p inline .
+ */
+static inline void dal_uwrite(DynarrLO *d, size_t index, void *obj) {
+    DAL_ASSERT(index < d->length);
+    d->array[index] = obj;
+}
+
+
+/**
+ * Appends an object without any checks. There must be room for at least one
+ * more element, see \p dal_reserve() .\n\n
+ * This function is declared \p static \p inline .
+ */
+static inline void dal_uappend(DynarrLO *d, void *obj) {
+    DAL_ASSERT(d->length < d->capacity);
+    d->array[d->length++] = obj;
+}
+
+
+/**
+ * Gets a pointer to the sized element at \p index without any checks.
+ * \p index must be less than length.\n\n
+ * This function is declared \p static \p inline .
+ */
+static inline void *dal_usget(const DynarrLO *d, size_t index) {
+    DAL_ASSERT(index < d->length);
+    return (unsigned char *) d->array + index * d->elemSize;
+}
+
+
+#if DAL_PRIMITIVE_SUPPORT
+
+/**
+ * Gets the value at \p index without any checks. \p index must be less
+ * than length.\n\n
+ * This function is declared \p static \p inline .
+ */
+static inline size_t dal_upget(const DynarrLO *d, size_t index) {
+    DAL_ASSERT(index < d->length);
+    return d->arrayp[index];
+}
+
+
+/**
+ * Writes a value at \p index without any checks. \p index must be less
+ * than length.\n\n
+ * This function is declared \p static \p inline .
+ */
+static inline void dal_upwrite(DynarrLO *d, size_t index, size_t val) {
+    DAL_ASSERT(index < d->length);
+    d->arrayp[index] = val;
+}
+
+
+/**
+ * Appends a value without any checks. There must be room for at least one
+ * more element, see \p dal_reserve() .\n\n
+ * This function is declared \p static \p inline .
+ */
+static inline void dal_upappend(DynarrLO *d, size_t val) {
+    DAL_ASSERT(d->length < d->capacity);
+    d->arrayp[d->length++] = val;
+}
+
+#endif // DAL_PRIMITIVE_SUPPORT
 #endif // EASY_DYNARRLO_H
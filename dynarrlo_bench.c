@@ -0,0 +1,786 @@
+//
+// Created by easy on 16.10.26.
+//
+// Microbenchmarks for the hot paths of DynarrLO, compared against a plain
+// realloc'd array and, if a C++ compiler is available, std::vector.
+//
+// Usage: dynarrlo_bench [maxExp] [reps]
+//   maxExp  Largest size is 10^maxExp elements (3..9, default 7).
+//           10^9 elements need roughly 8 GB of memory per array.
+//   reps    Every run is repeated this many times, the fastest one is
+//           reported (default 3).
+//
+// Every implementation sees the same deterministic access pattern. Output is
+// one line per benchmark, size and implementation with nanoseconds per
+// operation and bytes written or moved per operation.
+//
+// Benchmark bodies are prefixed with their implementation: lib_ for DynarrLO,
+// raw_ for the realloc'd array and vec_ for std::vector. The bench_ prefix is
+// reserved for the helpers shared with dynarrlo_bench_vector.cpp.
+
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "dynarrlo.h"
+#include "dynarrlo_bench.h"
+
+
+// Number of elements per operation of the *Many benchmarks.
+#define BATCH 16
+// Upper bound of the array size for benchmarks costing O(n) per operation.
+#define MAX_LINEAR 1000000
+// Number of operations for benchmarks costing O(n) per operation.
+#define LINEAR_OPS 10000
+
+// Returns the lesser of the two arguments.
+#define MIN(a, b) ((a) <= (b) ? (a) : (b))
+
+
+volatile size_t bench_sink;
+
+
+double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec * 1e9 + (double) ts.tv_nsec;
+}
+
+
+size_t bench_rand(size_t *state, size_t n) {
+    size_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x % n;
+}
+
+
+
+// Benchmarks can't do anything meaningful without their arrays.
+static void outOfMemory(void) {
+    fputs("out of memory\n", stderr);
+    exit(EXIT_FAILURE);
+}
+
+
+
+/*
+ * Raw array baseline. Grows by the same factor of 1.5 DynarrLO uses, so that
+ * the measured difference is the per-operation overhead.
+ */
+
+typedef struct RawArr {
+    size_t *a;
+    size_t len;
+    size_t cap;
+} RawArr;
+
+
+static void rawInit(RawArr *r, size_t cap) {
+    r->cap = cap < 2 ? 2 : cap;
+    r->len = 0;
+    r->a = malloc(r->cap * sizeof *r->a);
+
+    if (!r->a)
+        outOfMemory();
+}
+
+
+static void rawGrow(RawArr *r, size_t need) {
+    if (need <= r->cap)
+        return;
+
+    size_t cap = r->cap + r->cap / 2;
+    cap = cap < need ? need : cap;
+    size_t *a = realloc(r->a, cap * sizeof *a);
+
+    if (!a)
+        outOfMemory();
+
+    r->a = a;
+    r->cap = cap;
+}
+
+
+static void rawPush(RawArr *r, size_t v) {
+    rawGrow(r, r->len + 1);
+    r->a[r->len++] = v;
+}
+
+
+static void rawInsertMany(RawArr *r, size_t i, const size_t *v, size_t num) {
+    rawGrow(r, r->len + num);
+    memmove(r->a + i + num, r->a + i, (r->len - i) * sizeof *r->a);
+    memcpy(r->a + i, v, num * sizeof *r->a);
+    r->len += num;
+}
+
+
+static void rawRemoveMany(RawArr *r, size_t iStart, size_t iEnd) {
+    memmove(r->a + iStart, r->a + iEnd, (r->len - iEnd) * sizeof *r->a);
+    r->len -= iEnd - iStart;
+}
+
+
+static void rawFill(RawArr *r, size_t n) {
+    rawInit(r, n);
+
+    for (size_t i = 0; i < n; ++i)
+        r->a[i] = i;
+
+    r->len = n;
+}
+
+
+static void libFill(DynarrLO *d, size_t n) {
+    if (dal_createDynarrLO(d, n, realloc, free))
+        outOfMemory();
+
+    for (size_t i = 0; i < n; ++i)
+        dal_pappend(d, i);
+}
+
+
+// Index at which the positional benchmarks operate.
+typedef enum Where {
+    HEAD,
+    MIDDLE,
+    TAIL
+} Where;
+
+
+static size_t position(Where w, size_t len) {
+    return w == HEAD ? 0 : w == MIDDLE ? len / 2 : len;
+}
+
+
+// Bytes memmove'd when inserting or removing num elements at index i.
+static size_t tailBytes(size_t len, size_t i) {
+    return (len - i) * sizeof(size_t);
+}
+
+
+
+/*
+ * Append and growth.
+ */
+
+static void lib_append(size_t n, size_t k, BenchStat *st) {
+    (void) k;
+    DynarrLO d;
+
+    if (dal_createDynarrLO(&d, 0, realloc, free))
+        outOfMemory();
+
+    double t = bench_now();
+    for (size_t i = 0; i < n; ++i)
+        dal_append(&d, (void *) i);
+    st->ns = bench_now() - t;
+
+    st->ops = n;
+    st->bytes = n * sizeof(void *);
+    bench_sink = (size_t) dal_getLast(&d);
+    dal_destroyDynarrLO(&d);
+}
+
+
+static void lib_pappend(size_t n, size_t k, BenchStat *st) {
+    (void) k;
+    DynarrLO d;
+
+    if (dal_createDynarrLO(&d, 0, realloc, free))
+        outOfMemory();
+
+    double t = bench_now();
+    for (size_t i = 0; i < n; ++i)
+        dal_pappend(&d, i);
+    st->ns = bench_now() - t;
+
+    st->ops = n;
+    st->bytes = n * sizeof(size_t);
+    bench_sink = dal_pgetLast(&d);
+    dal_destroyDynarrLO(&d);
+}
+
+
+static void raw_append(size_t n, size_t k, BenchStat *st) {
+    (void) k;
+    RawArr r;
+    rawInit(&r, 0);
+
+    double t = bench_now();
+    for (size_t i = 0; i < n; ++i)
+        rawPush(&r, i);
+    st->ns = bench_now() - t;
+
+    st->ops = n;
+    st->bytes = n * sizeof(size_t);
+    bench_sink = r.a[r.len - 1];
+    free(r.a);
+}
+
+
+
+/*
+ * Sequential and random reads.
+ */
+
+static void lib_getSeq(size_t n, size_t k, BenchStat *st) {
+    DynarrLO d;
+    libFill(&d, n);
+    size_t sum = 0;
+
+    double t = bench_now();
+    for (size_t rep = 0; rep < k; ++rep)
+        for (size_t i = 0; i < n; ++i)
+            sum += (size_t) dal_get(&d, i);
+    st->ns = bench_now() - t;
+
+    st->ops = n * k;
+    st->bytes = 0;
+    bench_sink = sum;
+    dal_destroyDynarrLO(&d);
+}
+
+
+static void lib_pgetSeq(size_t n, size_t k, BenchStat *st) {
+    DynarrLO d;
+    libFill(&d, n);
+    size_t sum = 0;
+
+    double t = bench_now();
+    for (size_t rep = 0; rep < k; ++rep)
+        for (size_t i = 0; i < n; ++i)
+            sum += dal_pget(&d, i);
+    st->ns = bench_now() - t;
+
+    st->ops = n * k;
+    st->bytes = 0;
+    bench_sink = sum;
+    dal_destroyDynarrLO(&d);
+}
+
+
+static void raw_getSeq(size_t n, size_t k, BenchStat *st) {
+    RawArr r;
+    rawFill(&r, n);
+    size_t sum = 0;
+
+    double t = bench_now();
+    for (size_t rep = 0; rep < k; ++rep)
+        for (size_t i = 0; i < n; ++i)
+            sum += r.a[i];
+    st->ns = bench_now() - t;
+
+    st->ops = n * k;
+    st->bytes = 0;
+    bench_sink = sum;
+    free(r.a);
+}
+
+
+static void lib_getRand(size_t n, size_t k, BenchStat *st) {
+    DynarrLO d;
+    libFill(&d, n);
+    size_t sum = 0, seed = 88172645463325252u;
+
+    double t = bench_now();
+    for (size_t i = 0; i < n * k; ++i)
+        sum += (size_t) dal_get(&d, bench_rand(&seed, n));
+    st->ns = bench_now() - t;
+
+    st->ops = n * k;
+    st->bytes = 0;
+    bench_sink = sum;
+    dal_destroyDynarrLO(&d);
+}
+
+
+static void lib_pgetRand(size_t n, size_t k, BenchStat *st) {
+    DynarrLO d;
+    libFill(&d, n);
+    size_t sum = 0, seed = 88172645463325252u;
+
+    double t = bench_now();
+    for (size_t i = 0; i < n * k; ++i)
+        sum += dal_pget(&d, bench_rand(&seed, n));
+    st->ns = bench_now() - t;
+
+    st->ops = n * k;
+    st->bytes = 0;
+    bench_sink = sum;
+    dal_destroyDynarrLO(&d);
+}
+
+
+static void raw_getRand(size_t n, size_t k, BenchStat *st) {
+    RawArr r;
+    rawFill(&r, n);
+    size_t sum = 0, seed = 88172645463325252u;
+
+    double t = bench_now();
+    for (size_t i = 0; i < n * k; ++i)
+        sum += r.a[bench_rand(&seed, n)];
+    st->ns = bench_now() - t;
+
+    st->ops = n * k;
+    st->bytes = 0;
+    bench_sink = sum;
+    free(r.a);
+}
+
+
+
+/*
+ * Sequential writes, popping and length changes.
+ */
+
+static void lib_writeSeq(size_t n, size_t k, BenchStat *st) {
+    DynarrLO d;
+    libFill(&d, n);
+
+    double t = bench_now();
+    for (size_t rep = 0; rep < k; ++rep)
+        for (size_t i = 0; i < n; ++i)
+            dal_write(&d, i, (void *) (i ^ rep));
+    st->ns = bench_now() - t;
+
+    st->ops = n * k;
+    st->bytes = n * k * sizeof(void *);
+    bench_sink = (size_t) dal_getLast(&d);
+    dal_destroyDynarrLO(&d);
+}
+
+
+static void lib_pwriteSeq(size_t n, size_t k, BenchStat *st) {
+    DynarrLO d;
+    libFill(&d, n);
+
+    double t = bench_now();
+    for (size_t rep = 0; rep < k; ++rep)
+        for (size_t i = 0; i < n; ++i)
+            dal_pwrite(&d, i, i ^ rep);
+    st->ns = bench_now() - t;
+
+    st->ops = n * k;
+    st->bytes = n * k * sizeof(size_t);
+    bench_sink = dal_pgetLast(&d);
+    dal_destroyDynarrLO(&d);
+}
+
+
+static void raw_writeSeq(size_t n, size_t k, BenchStat *st) {
+    RawArr r;
+    rawFill(&r, n);
+
+    double t = bench_now();
+    for (size_t rep = 0; rep < k; ++rep)
+        for (size_t i = 0; i < n; ++i)
+            r.a[i] = i ^ rep;
+    st->ns = bench_now() - t;
+
+    st->ops = n * k;
+    st->bytes = n * k * sizeof(size_t);
+    bench_sink = r.a[r.len - 1];
+    free(r.a);
+}
+
+
+// Pops all n elements of a full array.
+static void lib_pop(size_t n, size_t k, BenchStat *st) {
+    (void) k;
+    DynarrLO d;
+    libFill(&d, n);
+    size_t sum = 0;
+
+    double t = bench_now();
+    for (size_t i = 0; i < n; ++i)
+        sum += (size_t) dal_pop(&d);
+    st->ns = bench_now() - t;
+
+    st->ops = n;
+    st->bytes = 0;
+    bench_sink = sum;
+    dal_destroyDynarrLO(&d);
+}
+
+
+static void lib_ppop(size_t n, size_t k, BenchStat *st) {
+    (void) k;
+    DynarrLO d;
+    libFill(&d, n);
+    size_t sum = 0;
+
+    double t = bench_now();
+    for (size_t i = 0; i < n; ++i)
+        sum += dal_ppop(&d);
+    st->ns = bench_now() - t;
+
+    st->ops = n;
+    st->bytes = 0;
+    bench_sink = sum;
+    dal_destroyDynarrLO(&d);
+}
+
+
+static void raw_pop(size_t n, size_t k, BenchStat *st) {
+    (void) k;
+    RawArr r;
+    rawFill(&r, n);
+    size_t sum = 0;
+
+    double t = bench_now();
+    for (size_t i = 0; i < n; ++i)
+        sum += r.a[--r.len];
+    st->ns = bench_now() - t;
+
+    st->ops = n;
+    st->bytes = 0;
+    bench_sink = sum;
+    free(r.a);
+}
+
+
+// Truncates an array of n elements step by step and extends it again.
+static void lib_setLength(size_t n, size_t k, BenchStat *st) {
+    DynarrLO d;
+    libFill(&d, n);
+    size_t sum = 0;
+
+    double t = bench_now();
+    for (size_t rep = 0; rep < k; ++rep)
+        for (size_t i = 0; i < n; ++i) {
+            dal_setLength(&d, rep & 1 ? i + 1 : n - i);
+            sum += dal_len(&d);
+        }
+    st->ns = bench_now() - t;
+
+    st->ops = n * k;
+    st->bytes = 0;
+    bench_sink = sum;
+    dal_destroyDynarrLO(&d);
+}
+
+
+static void raw_setLength(size_t n, size_t k, BenchStat *st) {
+    RawArr r;
+    rawFill(&r, n);
+    size_t sum = 0;
+
+    double t = bench_now();
+    for (size_t rep = 0; rep < k; ++rep)
+        for (size_t i = 0; i < n; ++i) {
+            r.len = MIN(rep & 1 ? i + 1 : n - i, r.cap);
+            sum += r.len;
+        }
+    st->ns = bench_now() - t;
+
+    st->ops = n * k;
+    st->bytes = 0;
+    bench_sink = sum;
+    free(r.a);
+}
+
+
+
+/*
+ * Positional insertion and removal. The array starts with n elements and k
+ * operations are done at the requested position.
+ */
+
+static void lib_insertAt(size_t n, size_t k, BenchStat *st, Where w) {
+    DynarrLO d;
+    libFill(&d, n);
+    size_t bytes = 0;
+
+    double t = bench_now();
+    for (size_t i = 0; i < k; ++i) {
+        size_t index = position(w, dal_len(&d));
+        bytes += tailBytes(dal_len(&d), index) + sizeof(size_t);
+        dal_pinsert(&d, index, i);
+    }
+    st->ns = bench_now() - t;
+
+    st->ops = k;
+    st->bytes = bytes;
+    bench_sink = dal_pget(&d, 0);
+    dal_destroyDynarrLO(&d);
+}
+
+
+static void raw_insertAt(size_t n, size_t k, BenchStat *st, Where w) {
+    RawArr r;
+    rawFill(&r, n);
+    size_t bytes = 0;
+
+    double t = bench_now();
+    for (size_t i = 0; i < k; ++i) {
+        size_t index = position(w, r.len);
+        bytes += tailBytes(r.len, index) + sizeof(size_t);
+        rawInsertMany(&r, index, &i, 1);
+    }
+    st->ns = bench_now() - t;
+
+    st->ops = k;
+    st->bytes = bytes;
+    bench_sink = r.a[0];
+    free(r.a);
+}
+
+
+static void lib_insertManyAt(size_t n, size_t k, BenchStat *st, Where w) {
+    DynarrLO d;
+    libFill(&d, n);
+    size_t batch[BATCH] = {0}, bytes = 0;
+
+    double t = bench_now();
+    for (size_t i = 0; i < k; ++i) {
+        size_t index = position(w, dal_len(&d));
+        bytes += tailBytes(dal_len(&d), index) + sizeof batch;
+        dal_pinsertMany(&d, index, batch, BATCH);
+    }
+    st->ns = bench_now() - t;
+
+    st->ops = k;
+    st->bytes = bytes;
+    bench_sink = dal_pget(&d, 0);
+    dal_destroyDynarrLO(&d);
+}
+
+
+static void raw_insertManyAt(size_t n, size_t k, BenchStat *st, Where w) {
+    RawArr r;
+    rawFill(&r, n);
+    size_t batch[BATCH] = {0}, bytes = 0;
+
+    double t = bench_now();
+    for (size_t i = 0; i < k; ++i) {
+        size_t index = position(w, r.len);
+        bytes += tailBytes(r.len, index) + sizeof batch;
+        rawInsertMany(&r, index, batch, BATCH);
+    }
+    st->ns = bench_now() - t;
+
+    st->ops = k;
+    st->bytes = bytes;
+    bench_sink = r.a[0];
+    free(r.a);
+}
+
+
+// The array is filled with n + k elements so that k removals leave n behind.
+static void lib_removeAt(size_t n, size_t k, BenchStat *st, Where w) {
+    DynarrLO d;
+    libFill(&d, n + k);
+    size_t bytes = 0;
+
+    double t = bench_now();
+    for (size_t i = 0; i < k; ++i) {
+        size_t index = position(w, dal_len(&d) - 1);
+        bytes += tailBytes(dal_len(&d), index + 1);
+        dal_remove(&d, index);
+    }
+    st->ns = bench_now() - t;
+
+    st->ops = k;
+    st->bytes = bytes;
+    bench_sink = dal_pget(&d, 0);
+    dal_destroyDynarrLO(&d);
+}
+
+
+static void raw_removeAt(size_t n, size_t k, BenchStat *st, Where w) {
+    RawArr r;
+    rawFill(&r, n + k);
+    size_t bytes = 0;
+
+    double t = bench_now();
+    for (size_t i = 0; i < k; ++i) {
+        size_t index = position(w, r.len - 1);
+        bytes += tailBytes(r.len, index + 1);
+        rawRemoveMany(&r, index, index + 1);
+    }
+    st->ns = bench_now() - t;
+
+    st->ops = k;
+    st->bytes = bytes;
+    bench_sink = r.a[0];
+    free(r.a);
+}
+
+
+static void lib_removeMany(size_t n, size_t k, BenchStat *st) {
+    DynarrLO d;
+    libFill(&d, n + k * BATCH);
+    size_t bytes = 0;
+
+    double t = bench_now();
+    for (size_t i = 0; i < k; ++i) {
+        size_t index = dal_len(&d) / 2;
+        bytes += tailBytes(dal_len(&d), index + BATCH);
+        dal_removeMany(&d, index, index + BATCH);
+    }
+    st->ns = bench_now() - t;
+
+    st->ops = k;
+    st->bytes = bytes;
+    bench_sink = dal_pget(&d, 0);
+    dal_destroyDynarrLO(&d);
+}
+
+
+static void raw_removeMany(size_t n, size_t k, BenchStat *st) {
+    RawArr r;
+    rawFill(&r, n + k * BATCH);
+    size_t bytes = 0;
+
+    double t = bench_now();
+    for (size_t i = 0; i < k; ++i) {
+        size_t index = r.len / 2;
+        bytes += tailBytes(r.len, index + BATCH);
+        rawRemoveMany(&r, index, index + BATCH);
+    }
+    st->ns = bench_now() - t;
+
+    st->ops = k;
+    st->bytes = bytes;
+    bench_sink = r.a[0];
+    free(r.a);
+}
+
+
+#define POSITIONAL(impl, op)                                               \
+static void impl##_##op##Head(size_t n, size_t k, BenchStat *st) {         \
+    impl##_##op##At(n, k, st, HEAD);                                       \
+}                                                                          \
+static void impl##_##op##Middle(size_t n, size_t k, BenchStat *st) {       \
+    impl##_##op##At(n, k, st, MIDDLE);                                     \
+}                                                                          \
+static void impl##_##op##Tail(size_t n, size_t k, BenchStat *st) {         \
+    impl##_##op##At(n, k, st, TAIL);                                       \
+}
+
+POSITIONAL(lib, insert)
+POSITIONAL(raw, insert)
+POSITIONAL(lib, insertMany)
+POSITIONAL(raw, insertMany)
+POSITIONAL(lib, remove)
+POSITIONAL(raw, remove)
+
+
+
+/*
+ * Driver.
+ */
+
+// How the size parameter of a benchmark is used.
+typedef enum Kind {
+    GROWTH,     // n operations filling an empty array or draining a full one
+    READ,       // n * k reads on an array of n elements
+    LINEAR      // k operations on an array of n elements
+} Kind;
+
+
+typedef struct Bench {
+    const char *name;
+    Kind kind;
+    BenchBody dal;
+    BenchBody raw;
+    BenchBody vec;
+} Bench;
+
+
+#if DAL_BENCH_VECTOR
+#define VEC(fn) fn
+#else
+#define VEC(fn) NULL
+#endif
+
+static const Bench benches[] = {
+    {"append",            GROWTH, lib_append,           raw_append,           VEC(vec_append)},
+    {"pappend",           GROWTH, lib_pappend,          raw_append,           VEC(vec_append)},
+    {"get/seq",           READ,   lib_getSeq,           raw_getSeq,           VEC(vec_getSeq)},
+    {"pget/seq",          READ,   lib_pgetSeq,          raw_getSeq,           VEC(vec_getSeq)},
+    {"write/seq",         READ,   lib_writeSeq,         raw_writeSeq,         VEC(vec_writeSeq)},
+    {"pwrite/seq",        READ,   lib_pwriteSeq,        raw_writeSeq,         VEC(vec_writeSeq)},
+    {"get/rand",          READ,   lib_getRand,          raw_getRand,          VEC(vec_getRand)},
+    {"pget/rand",         READ,   lib_pgetRand,         raw_getRand,          VEC(vec_getRand)},
+    {"pop",               GROWTH, lib_pop,              raw_pop,              VEC(vec_pop)},
+    {"ppop",              GROWTH, lib_ppop,             raw_pop,              VEC(vec_pop)},
+    {"setLength",         READ,   lib_setLength,        raw_setLength,        NULL},
+    {"insert/head",       LINEAR, lib_insertHead,       raw_insertHead,       VEC(vec_insertHead)},
+    {"insert/middle",     LINEAR, lib_insertMiddle,     raw_insertMiddle,     VEC(vec_insertMiddle)},
+    {"insert/tail",       LINEAR, lib_insertTail,       raw_insertTail,       VEC(vec_insertTail)},
+    {"insertMany/head",   LINEAR, lib_insertManyHead,   raw_insertManyHead,   VEC(vec_insertManyHead)},
+    {"insertMany/middle", LINEAR, lib_insertManyMiddle, raw_insertManyMiddle, VEC(vec_insertManyMiddle)},
+    {"insertMany/tail",   LINEAR, lib_insertManyTail,   raw_insertManyTail,   VEC(vec_insertManyTail)},
+    {"remove/head",       LINEAR, lib_removeHead,       raw_removeHead,       VEC(vec_removeHead)},
+    {"remove/middle",     LINEAR, lib_removeMiddle,     raw_removeMiddle,     VEC(vec_removeMiddle)},
+    {"remove/tail",       LINEAR, lib_removeTail,       raw_removeTail,       VEC(vec_removeTail)},
+    {"removeMany",        LINEAR, lib_removeMany,       raw_removeMany,       VEC(vec_removeMany)},
+};
+
+
+static void run(const Bench *b, const char *impl, BenchBody body,
+                size_t n, size_t k, unsigned reps) {
+    if (!body)
+        return;
+
+    BenchStat best = {0};
+
+    for (unsigned r = 0; r < reps; ++r) {
+        BenchStat st = {0};
+        body(n, k, &st);
+
+        if (r == 0 || st.ns < best.ns)
+            best = st;
+    }
+
+    printf("%-18s %12zu  %-6s %12.3f ns/op %12.1f B/op\n",
+           b->name, n, impl,
+           best.ns / (double) best.ops,
+           (double) best.bytes / (double) best.ops);
+}
+
+
+int main(int argc, char **argv) {
+    int maxExp = argc > 1 ? atoi(argv[1]) : 7;
+    int reps = argc > 2 ? atoi(argv[2]) : 3;
+
+    if (maxExp < 3 || maxExp > 9 || reps < 1) {
+        fprintf(stderr, "usage: %s [maxExp 3..9] [reps >= 1]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    printf("%-18s %12s  %-6s %18s %17s\n",
+           "benchmark", "n", "impl", "time", "moved");
+
+    for (size_t i = 0; i < sizeof benches / sizeof *benches; ++i) {
+        const Bench *b = benches + i;
+
+        for (size_t n = 1000, e = 3; e <= (size_t) maxExp; n *= 10, ++e) {
+            size_t k = 1;
+
+            if (b->kind == LINEAR) {
+                if (n > MAX_LINEAR)
+                    break;
+                k = MIN(n, LINEAR_OPS);
+            } else if (b->kind == READ) {
+                // Keep the number of reads of small arrays statistically useful
+                k = MIN(10000000 / n, 1000);
+                k += !k;
+            }
+
+            run(b, "dal", b->dal, n, k, (unsigned) reps);
+            run(b, "raw", b->raw, n, k, (unsigned) reps);
+            run(b, "vector", b->vec, n, k, (unsigned) reps);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
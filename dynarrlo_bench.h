@@ -0,0 +1,87 @@
+//
+// Created by easy on 16.10.26.
+//
+
+#ifndef EASY_DYNARRLO_BENCH_H
+#define EASY_DYNARRLO_BENCH_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Result of a single benchmark run. Every benchmark body fills in all fields.
+ */
+typedef struct BenchStat {
+    /**
+     * Number of operations performed inside the timed region.
+     */
+    size_t ops;
+
+    /**
+     * Number of bytes written or moved by the operations in the timed region,
+     * not counting copies done internally by \p realloc() .
+     */
+    size_t bytes;
+
+    /**
+     * Wall clock time of the timed region in nanoseconds.
+     */
+    double ns;
+} BenchStat;
+
+
+/**
+ * Signature of every benchmark body. \p n is the size parameter of the run,
+ * \p k the number of operations for benchmarks whose cost depends on \p n per
+ * operation.
+ */
+typedef void (*BenchBody)(size_t n, size_t k, BenchStat *st);
+
+
+/**
+ * Monotonic wall clock in nanoseconds.
+ */
+double bench_now(void);
+
+
+/**
+ * Pseudo random index in [0, n) from a deterministic xorshift sequence, so that
+ * every implementation sees the same access pattern.
+ */
+size_t bench_rand(size_t *state, size_t n);
+
+
+/**
+ * Sink for benchmark results so the compiler cannot remove the measured loops.
+ */
+extern volatile size_t bench_sink;
+
+
+#if DAL_BENCH_VECTOR
+void vec_append(size_t n, size_t k, BenchStat *st);
+void vec_getSeq(size_t n, size_t k, BenchStat *st);
+void vec_getRand(size_t n, size_t k, BenchStat *st);
+void vec_writeSeq(size_t n, size_t k, BenchStat *st);
+void vec_pop(size_t n, size_t k, BenchStat *st);
+void vec_insertHead(size_t n, size_t k, BenchStat *st);
+void vec_insertMiddle(size_t n, size_t k, BenchStat *st);
+void vec_insertTail(size_t n, size_t k, BenchStat *st);
+void vec_insertManyHead(size_t n, size_t k, BenchStat *st);
+void vec_insertManyMiddle(size_t n, size_t k, BenchStat *st);
+void vec_insertManyTail(size_t n, size_t k, BenchStat *st);
+void vec_removeHead(size_t n, size_t k, BenchStat *st);
+void vec_removeMiddle(size_t n, size_t k, BenchStat *st);
+void vec_removeTail(size_t n, size_t k, BenchStat *st);
+void vec_removeMany(size_t n, size_t k, BenchStat *st);
+#endif
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EASY_DYNARRLO_BENCH_H
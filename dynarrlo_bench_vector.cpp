@@ -0,0 +1,231 @@
+//
+// Created by easy on 16.10.26.
+//
+// std::vector baseline for dynarrlo_bench. Mirrors the raw array baseline in
+// dynarrlo_bench.c operation for operation.
+
+
+#include <cstddef>
+#include <vector>
+#include "dynarrlo_bench.h"
+
+
+namespace {
+
+constexpr std::size_t BATCH = 16;
+
+enum Where { HEAD, MIDDLE, TAIL };
+
+
+std::size_t position(Where w, std::size_t len) {
+    return w == HEAD ? 0 : w == MIDDLE ? len / 2 : len;
+}
+
+
+std::size_t tailBytes(std::size_t len, std::size_t i) {
+    return (len - i) * sizeof(std::size_t);
+}
+
+
+std::vector<std::size_t> filled(std::size_t n) {
+    std::vector<std::size_t> v;
+    v.reserve(n);
+
+    for (std::size_t i = 0; i < n; ++i)
+        v.push_back(i);
+
+    return v;
+}
+
+
+void insertAt(std::size_t n, std::size_t k, BenchStat *st, Where w) {
+    auto v = filled(n);
+    std::size_t bytes = 0;
+
+    double t = bench_now();
+    for (std::size_t i = 0; i < k; ++i) {
+        std::size_t index = position(w, v.size());
+        bytes += tailBytes(v.size(), index) + sizeof(std::size_t);
+        v.insert(v.begin() + index, i);
+    }
+    st->ns = bench_now() - t;
+
+    st->ops = k;
+    st->bytes = bytes;
+    bench_sink = v[0];
+}
+
+
+void insertManyAt(std::size_t n, std::size_t k, BenchStat *st, Where w) {
+    auto v = filled(n);
+    std::size_t batch[BATCH] = {}, bytes = 0;
+
+    double t = bench_now();
+    for (std::size_t i = 0; i < k; ++i) {
+        std::size_t index = position(w, v.size());
+        bytes += tailBytes(v.size(), index) + sizeof batch;
+        v.insert(v.begin() + index, batch, batch + BATCH);
+    }
+    st->ns = bench_now() - t;
+
+    st->ops = k;
+    st->bytes = bytes;
+    bench_sink = v[0];
+}
+
+
+void removeAt(std::size_t n, std::size_t k, BenchStat *st, Where w) {
+    auto v = filled(n + k);
+    std::size_t bytes = 0;
+
+    double t = bench_now();
+    for (std::size_t i = 0; i < k; ++i) {
+        std::size_t index = position(w, v.size() - 1);
+        bytes += tailBytes(v.size(), index + 1);
+        v.erase(v.begin() + index);
+    }
+    st->ns = bench_now() - t;
+
+    st->ops = k;
+    st->bytes = bytes;
+    bench_sink = v[0];
+}
+
+} // namespace
+
+
+
+extern "C" {
+
+void vec_append(std::size_t n, std::size_t, BenchStat *st) {
+    std::vector<std::size_t> v;
+
+    double t = bench_now();
+    for (std::size_t i = 0; i < n; ++i)
+        v.push_back(i);
+    st->ns = bench_now() - t;
+
+    st->ops = n;
+    st->bytes = n * sizeof(std::size_t);
+    bench_sink = v.back();
+}
+
+
+void vec_getSeq(std::size_t n, std::size_t k, BenchStat *st) {
+    auto v = filled(n);
+    std::size_t sum = 0;
+
+    double t = bench_now();
+    for (std::size_t rep = 0; rep < k; ++rep)
+        for (std::size_t i = 0; i < n; ++i)
+            sum += v[i];
+    st->ns = bench_now() - t;
+
+    st->ops = n * k;
+    st->bytes = 0;
+    bench_sink = sum;
+}
+
+
+void vec_getRand(std::size_t n, std::size_t k, BenchStat *st) {
+    auto v = filled(n);
+    std::size_t sum = 0, seed = 88172645463325252u;
+
+    double t = bench_now();
+    for (std::size_t i = 0; i < n * k; ++i)
+        sum += v[bench_rand(&seed, n)];
+    st->ns = bench_now() - t;
+
+    st->ops = n * k;
+    st->bytes = 0;
+    bench_sink = sum;
+}
+
+
+void vec_writeSeq(std::size_t n, std::size_t k, BenchStat *st) {
+    auto v = filled(n);
+
+    double t = bench_now();
+    for (std::size_t rep = 0; rep < k; ++rep)
+        for (std::size_t i = 0; i < n; ++i)
+            v[i] = i ^ rep;
+    st->ns = bench_now() - t;
+
+    st->ops = n * k;
+    st->bytes = n * k * sizeof(std::size_t);
+    bench_sink = v.back();
+}
+
+
+void vec_pop(std::size_t n, std::size_t, BenchStat *st) {
+    auto v = filled(n);
+    std::size_t sum = 0;
+
+    double t = bench_now();
+    for (std::size_t i = 0; i < n; ++i) {
+        sum += v.back();
+        v.pop_back();
+    }
+    st->ns = bench_now() - t;
+
+    st->ops = n;
+    st->bytes = 0;
+    bench_sink = sum;
+}
+
+
+void vec_insertHead(std::size_t n, std::size_t k, BenchStat *st) {
+    insertAt(n, k, st, HEAD);
+}
+
+void vec_insertMiddle(std::size_t n, std::size_t k, BenchStat *st) {
+    insertAt(n, k, st, MIDDLE);
+}
+
+void vec_insertTail(std::size_t n, std::size_t k, BenchStat *st) {
+    insertAt(n, k, st, TAIL);
+}
+
+void vec_insertManyHead(std::size_t n, std::size_t k, BenchStat *st) {
+    insertManyAt(n, k, st, HEAD);
+}
+
+void vec_insertManyMiddle(std::size_t n, std::size_t k, BenchStat *st) {
+    insertManyAt(n, k, st, MIDDLE);
+}
+
+void vec_insertManyTail(std::size_t n, std::size_t k, BenchStat *st) {
+    insertManyAt(n, k, st, TAIL);
+}
+
+void vec_removeHead(std::size_t n, std::size_t k, BenchStat *st) {
+    removeAt(n, k, st, HEAD);
+}
+
+void vec_removeMiddle(std::size_t n, std::size_t k, BenchStat *st) {
+    removeAt(n, k, st, MIDDLE);
+}
+
+void vec_removeTail(std::size_t n, std::size_t k, BenchStat *st) {
+    removeAt(n, k, st, TAIL);
+}
+
+
+void vec_removeMany(std::size_t n, std::size_t k, BenchStat *st) {
+    auto v = filled(n + k * BATCH);
+    std::size_t bytes = 0;
+
+    double t = bench_now();
+    for (std::size_t i = 0; i < k; ++i) {
+        std::size_t index = v.size() / 2;
+        bytes += tailBytes(v.size(), index + BATCH);
+        v.erase(v.begin() + index, v.begin() + index + BATCH);
+    }
+    st->ns = bench_now() - t;
+
+    st->ops = k;
+    st->bytes = bytes;
+    bench_sink = v[0];
+}
+
+} // extern "C"
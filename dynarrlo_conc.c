@@ -0,0 +1,287 @@
+//
+// Created by easy on 16.10.26.
+//
+
+
+#include "dynarrlo_conc.h"
+#include <stdbool.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sched.h>
+#define YIELD() sched_yield()
+#else
+#define YIELD() ((void) 0)
+#endif
+
+
+// Returns the lesser of the two arguments.
+#define MIN(a, b) ((a) <= (b) ? (a) : (b))
+
+// Largest shift of the first bucket.
+#define MAX_SHIFT 30
+
+// Tells the CPU that the thread is waiting for another one.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define CPU_RELAX() __builtin_ia32_pause()
+#else
+#define CPU_RELAX() ((void) 0)
+#endif
+
+// Number of spins after which a waiting thread yields its time slice.
+#define SPINS 64
+
+
+// Marks a bucket that is being allocated by some thread.
+static void *busy;
+#define BUSY (&busy)
+
+
+/**
+ * Waits a little for another thread. Spins at first and then yields, so the
+ * other thread gets to run even if there are more threads than CPUs.
+ */
+static void backOff(unsigned *spins) {
+    if (++*spins < SPINS) {
+        CPU_RELAX();
+    } else {
+        *spins = 0;
+        YIELD();
+    }
+}
+
+
+static size_t itemsToBytes(size_t n) {
+    return n * sizeof(void *);
+}
+
+
+static size_t log2Floor(size_t n) {
+#if defined(__GNUC__) || defined(__clang__)
+    return sizeof(unsigned long long) * CHAR_BIT - 1 -
+           (size_t) __builtin_clzll(n);
+#else
+    size_t log = 0;
+
+    while (n >>= 1)
+        ++log;
+
+    return log;
+#endif
+}
+
+
+static size_t bucketSize(const DalConcArray *c, size_t bucket) {
+    return (size_t) 1 << (c->shift + bucket);
+}
+
+
+// Index of the first slot of a bucket.
+static size_t bucketStart(const DalConcArray *c, size_t bucket) {
+    return bucketSize(c, bucket) - bucketSize(c, 0);
+}
+
+
+/**
+ * Finds the bucket of a slot. Buckets start at multiples of the size of the
+ * first bucket minus one, so shifting the index by it yields the bucket.
+ * Writes the position of the slot within the bucket to offset.
+ */
+static size_t bucketOf(const DalConcArray *c, size_t index, size_t *offset) {
+    size_t i = index + bucketSize(c, 0);
+    size_t bucket = log2Floor(i >> c->shift);
+    *offset = i - bucketSize(c, bucket);
+    return bucket;
+}
+
+
+/**
+ * Makes sure that a bucket is allocated. The thread that gets to mark the
+ * bucket as busy allocates it, all others wait until it is done. A failed
+ * allocation lets the array fail unless it was done ahead of time.
+ * @return True iff the bucket is allocated.
+ */
+static bool ensureBucket(DalConcArray *c, size_t bucket, bool ahead) {
+    if (bucket >= DAL_CONC_BUCKETS - c->shift) {
+        if (!ahead)
+            atomic_store(&c->failed, true);
+
+        return ahead;
+    }
+
+    _Atomic(void **) *slot = c->buckets + bucket;
+    unsigned spins = 0;
+
+    for (;;) {
+        void **b = atomic_load_explicit(slot, memory_order_acquire);
+
+        if (b && b != BUSY)
+            return true;
+
+        if (atomic_load_explicit(&c->failed, memory_order_relaxed))
+            return false;
+
+        void **expected = NULL;
+
+        if (b || !atomic_compare_exchange_strong(slot, &expected, BUSY)) {
+            if (ahead)
+                return true;
+
+            backOff(&spins);
+            continue;
+        }
+
+        b = c->realloc(NULL, itemsToBytes(bucketSize(c, bucket)));
+
+        if (!b && !ahead)
+            atomic_store(&c->failed, true);
+
+        atomic_store_explicit(slot, b, memory_order_release);
+        return b || ahead;
+    }
+}
+
+
+static void **slotAt(DalConcArray *c, size_t index) {
+    size_t offset;
+    size_t bucket = bucketOf(c, index, &offset);
+    void **b = atomic_load_explicit(c->buckets + bucket, memory_order_relaxed);
+    return b + offset;
+}
+
+
+
+DAL_ERROR dal_createConcArray(DalConcArray *c,
+                              size_t shift,
+                              void *(*realloc) (void *, size_t),
+                              void (*free) (void *)) {
+
+    if (!c || !realloc || !free)
+        return DAL_NULLARG;
+
+    for (size_t k = 0; k < DAL_CONC_BUCKETS; ++k)
+        atomic_init(c->buckets + k, NULL);
+
+    atomic_init(&c->reserved, 0);
+    atomic_init(&c->committed, 0);
+    atomic_init(&c->failed, false);
+    c->shift = MIN(shift, MAX_SHIFT);
+    c->realloc = realloc;
+    c->free = free;
+
+    if (!ensureBucket(c, 0, false)) {
+        *c = (DalConcArray) {0};
+        return DAL_ALLOCFAIL;
+    }
+
+    return DAL_OK;
+}
+
+
+void dal_destroyConcArray(DalConcArray *c) {
+    for (size_t k = 0; k < DAL_CONC_BUCKETS; ++k)
+        c->free(atomic_load(c->buckets + k));
+
+    *c = (DalConcArray) {0};
+}
+
+
+size_t dal_concLen(DalConcArray *c) {
+    return atomic_load_explicit(&c->committed, memory_order_acquire);
+}
+
+
+DAL_ERROR dal_concReserve(DalConcArray *c, size_t n, size_t *first) {
+    size_t f = atomic_fetch_add_explicit(&c->reserved, n, memory_order_relaxed);
+    size_t offset;
+    *first = f;
+
+    if (!n)
+        return DAL_OK;
+
+    size_t last = bucketOf(c, f + n - 1, &offset);
+
+    for (size_t k = bucketOf(c, f, &offset); k <= last; ++k)
+        if (!ensureBucket(c, k, false))
+            return DAL_ALLOCFAIL;
+
+    // The reservation of the middle slot of a bucket allocates the next one
+    size_t mid = bucketStart(c, last) + bucketSize(c, last) / 2;
+
+    if (f <= mid && mid < f + n)
+        ensureBucket(c, last + 1, true);
+
+    return DAL_OK;
+}
+
+
+void **dal_concSlot(DalConcArray *c, size_t index) {
+    return slotAt(c, index);
+}
+
+
+DAL_ERROR dal_concCommit(DalConcArray *c, size_t first, size_t n) {
+    unsigned spins = 0;
+
+    while (atomic_load_explicit(&c->committed, memory_order_acquire) != first) {
+        if (atomic_load_explicit(&c->failed, memory_order_relaxed))
+            return DAL_ALLOCFAIL;
+
+        backOff(&spins);
+    }
+
+    atomic_store_explicit(&c->committed, first + n, memory_order_release);
+    return DAL_OK;
+}
+
+
+DAL_ERROR dal_concAppend(DalConcArray *c, void *obj) {
+    size_t index;
+
+    if (dal_concReserve(c, 1, &index))
+        return DAL_ALLOCFAIL;
+
+    *slotAt(c, index) = obj;
+    return dal_concCommit(c, index, 1);
+}
+
+
+void *dal_concGet(DalConcArray *c, size_t index) {
+    return index < dal_concLen(c) ? *slotAt(c, index) : NULL;
+}
+
+
+DAL_ERROR dal_concToDynarrLO(DalConcArray *c, DynarrLO *d) {
+    size_t length = dal_concLen(c);
+    DAL_ERROR error = dal_createDynarrLO(d, length, c->realloc, c->free);
+
+    if (error)
+        return error;
+
+    for (size_t k = 0; bucketStart(c, k) < length; ++k) {
+        void **b = atomic_load_explicit(c->buckets + k, memory_order_relaxed);
+        dal_appendMany(d, b, MIN(length - bucketStart(c, k), bucketSize(c, k)));
+    }
+
+    return DAL_OK;
+}
+
+
+
+#if DAL_PRIMITIVE_SUPPORT
+
+DAL_ERROR dal_pconcAppend(DalConcArray *c, size_t val) {
+    size_t index;
+
+    if (dal_concReserve(c, 1, &index))
+        return DAL_ALLOCFAIL;
+
+    *(size_t *) slotAt(c, index) = val;
+    return dal_concCommit(c, index, 1);
+}
+
+
+size_t dal_pconcGet(DalConcArray *c, size_t index) {
+    return index < dal_concLen(c) ? *(size_t *) slotAt(c, index) : 0;
+}
+
+#endif // DAL_PRIMITIVE_SUPPORT
@@ -0,0 +1,195 @@
+//
+// Created by easy on 16.10.26.
+//
+
+#ifndef EASY_DYNARRLO_CONC_H
+#define EASY_DYNARRLO_CONC_H
+
+#include "dynarrlo.h"
+#include <limits.h>
+#include <stdatomic.h>
+
+
+/**
+ * Maximum number of buckets of a concurrent array.
+ */
+#define DAL_CONC_BUCKETS (sizeof(size_t) * CHAR_BIT)
+
+
+/**
+ * An append-only array that many threads may append to and read from at the
+ * same time without any locks.\n\n
+ *
+ * Appending is done in three steps. A producer reserves slots with a single
+ * atomic fetch-add, writes its elements into them and then commits them.
+ * Commits are published in index order, i.e. a commit waits until all slots
+ * in front of it have been committed. Readers only ever see committed slots,
+ * which are fully written.\n\n
+ *
+ * The elements are stored in buckets that double in size, so the array grows
+ * without ever moving elements and references to elements stay valid. Exactly
+ * one thread allocates a bucket while the others wait for it. The thread that
+ * reserves the middle slot of a bucket allocates the next bucket ahead of
+ * time, so producers rarely have to wait at all.\n\n
+ *
+ * The functions of a concurrent array report errors through their return
+ * values instead of an error flag, which would be shared by all threads. If a
+ * bucket couldn't be allocated, the array fails for good: all further
+ * reservations and commits return \p DAL_ALLOCFAIL , while committed elements
+ * can still be read.\n\n
+ *
+ * Do not modify or access the fields of this struct manually.
+ */
+typedef struct DalConcArray {
+    /**
+     * Bucket k holds 2 to the power of shift + k elements. Unallocated buckets
+     * are NULL.
+     */
+    _Atomic(void **) buckets[DAL_CONC_BUCKETS];
+
+    /**
+     * Number of reserved slots.
+     */
+    atomic_size_t reserved;
+
+    /**
+     * Number of committed slots. Every slot below it is fully written.
+     */
+    atomic_size_t committed;
+
+    /**
+     * Set once a bucket couldn't be allocated.
+     */
+    atomic_bool failed;
+
+    /**
+     * The first bucket holds 2 to the power of \p shift elements.
+     */
+    size_t shift;
+
+    /**
+     * A \p realloc() function conforming to the C standard. Must be thread
+     * safe.
+     */
+    void *(*realloc) (void *ptr, size_t size);
+
+    /**
+     * A \p free() function conforming to the C standard.
+     */
+    void  (*free)    (void *ptr);
+} DalConcArray;
+
+
+/**
+ * Tries to create a concurrent array and allocates its first bucket. Does
+ * nothing on failure. Must not be called while other threads access the array.
+ * @param c Pointer to concurrent array object that shall be initialised.
+ * @param shift The first bucket holds 2 to the power of \p shift elements.
+ * Values above 30 are treated as 30.
+ * @param realloc Thread safe realloc function conforming to the C standard.
+ * @param free free function conforming to the C standard.
+ * @return Error code indicating either success \p(DAL_OK), a null argument
+ * error \p(DAL_NULLARG) or failure to allocate the requested amount of memory
+ * \p (DAL_ALLOCFAIL) .
+ */
+DAL_ERROR dal_createConcArray(DalConcArray *c,
+                              size_t shift,
+                              void *(*realloc) (void *, size_t),
+                              void (*free) (void *));
+
+
+/**
+ * Frees all buckets and sets all struct fields to 0. Must not be called while
+ * other threads access the array. Elements residing in the array are not
+ * automatically freed.
+ */
+void dal_destroyConcArray(DalConcArray *c);
+
+
+/**
+ * Gets the number of committed elements, which may be read. Safe to call
+ * concurrently.
+ * @return Number of committed elements.
+ */
+size_t dal_concLen(DalConcArray *c);
+
+
+/**
+ * Reserves \p n consecutive slots and makes sure that buckets for all of them
+ * are allocated. Each reservation must be committed with \p dal_concCommit()
+ * once its slots have been written. Safe to call concurrently.
+ * @param n Number of slots to reserve.
+ * @param first Receives the index of the first reserved slot.
+ * @return \p DAL_OK or \p DAL_ALLOCFAIL if a bucket couldn't be allocated.
+ */
+DAL_ERROR dal_concReserve(DalConcArray *c, size_t n, size_t *first);
+
+
+/**
+ * Gets the address of a reserved slot, which the thread that reserved it may
+ * write to. Slots of a reservation are only contiguous within a bucket.
+ * @param index Index of a slot reserved by the calling thread.
+ * @return Address of the slot.
+ */
+void **dal_concSlot(DalConcArray *c, size_t index);
+
+
+/**
+ * Publishes the \p n slots reserved at index \p first to readers. Waits until
+ * all slots in front of them have been committed. Safe to call concurrently.
+ * @param first Index of the first reserved slot, as returned by
+ * \p dal_concReserve() .
+ * @param n Number of reserved slots.
+ * @return \p DAL_OK or \p DAL_ALLOCFAIL if the array has failed, in which case
+ * the slots are not committed.
+ */
+DAL_ERROR dal_concCommit(DalConcArray *c, size_t first, size_t n);
+
+
+/**
+ * Appends an object by reserving, writing and committing a single slot. Safe
+ * to call concurrently.
+ * @param obj Object to append.
+ * @return \p DAL_OK or \p DAL_ALLOCFAIL if the array has failed.
+ */
+DAL_ERROR dal_concAppend(DalConcArray *c, void *obj);
+
+
+/**
+ * Gets a committed element. Safe to call concurrently.
+ * @param index Index to access.
+ * @return Element at \p index or NULL if \p index is not committed yet.
+ */
+void *dal_concGet(DalConcArray *c, size_t index);
+
+
+/**
+ * Copies all committed elements into a newly created DynarrLO, which uses the
+ * \p realloc() and \p free() functions of the concurrent array. Must not be
+ * called while other threads append to the array.
+ * @param d Pointer to DynarrLO object that shall be initialised.
+ * @return Error code indicating either success \p(DAL_OK) or failure to
+ * allocate the requested amount of memory \p (DAL_ALLOCFAIL) .
+ */
+DAL_ERROR dal_concToDynarrLO(DalConcArray *c, DynarrLO *d);
+
+
+#if DAL_PRIMITIVE_SUPPORT
+
+/**
+ * Primitive version of \p dal_concAppend() .
+ * @param val Value to append.
+ * @return \p DAL_OK or \p DAL_ALLOCFAIL if the array has failed.
+ */
+DAL_ERROR dal_pconcAppend(DalConcArray *c, size_t val);
+
+
+/**
+ * Primitive version of \p dal_concGet() .
+ * @param index Index to access.
+ * @return Value at \p index or 0 if \p index is not committed yet.
+ */
+size_t dal_pconcGet(DalConcArray *c, size_t index);
+
+#endif // DAL_PRIMITIVE_SUPPORT
+#endif // EASY_DYNARRLO_CONC_H
@@ -0,0 +1,239 @@
+//
+// Created by easy on 16.10.26.
+//
+
+
+#include "dynarrlo_deque.h"
+#include <stdbool.h>
+#include <string.h>
+
+
+static size_t itemsToBytes(size_t n) {
+    return n * sizeof(void *);
+}
+
+
+static size_t mask(const DalDeque *q) {
+    return q->base.capacity - 1;
+}
+
+
+/**
+ * Translates an index into a position in the ring. Any index >= length is
+ * redirected to the padding element.
+ */
+static size_t position(const DalDeque *q, size_t index) {
+    size_t pos = (q->head + index) & mask(q);
+    return index < q->base.length ? pos : q->base.capacity;
+}
+
+
+// Position of the last element or the padding element if the deque is empty.
+static size_t lastPosition(const DalDeque *q) {
+    return position(q, q->base.length - 1);
+}
+
+
+/**
+ * Doubles the capacity if the ring is full. The ring is unwrapped by moving
+ * the shorter of its two parts behind the other one.
+ * @return True iff memory allocation failed.
+ */
+static bool growRing(DalDeque *q) {
+    DynarrLO *d = &q->base;
+    size_t capacity = d->capacity;
+
+    if (d->length < capacity)
+        return false;
+
+    dal_setCapacity(d, capacity * 2);
+    if (d->error)
+        return true;
+
+    size_t front = capacity - q->head;
+
+    if (q->head <= front) {
+        memcpy(d->array + capacity, d->array, itemsToBytes(q->head));
+    } else {
+        memcpy(d->array + capacity + q->head,
+               d->array + q->head,
+               itemsToBytes(front));
+        q->head += capacity;
+    }
+
+    return false;
+}
+
+
+// Claims the slot in front of the first element. Returns its position.
+static size_t pushFront(DalDeque *q) {
+    q->head = (q->head - 1) & mask(q);
+    ++q->base.length;
+    return q->head;
+}
+
+
+// Claims the slot behind the last element. Returns its position.
+static size_t pushBack(DalDeque *q) {
+    return (q->head + q->base.length++) & mask(q);
+}
+
+
+// Releases the first element. Returns its position or the padding element.
+static size_t popFront(DalDeque *q) {
+    size_t pos = position(q, 0);
+    size_t nonempty = !!q->base.length;
+    q->base.error = !nonempty;
+    q->head = (q->head + nonempty) & mask(q);
+    q->base.length -= nonempty;
+    return pos;
+}
+
+
+// Releases the last element. Returns its position or the padding element.
+static size_t popBack(DalDeque *q) {
+    size_t pos = lastPosition(q);
+    q->base.error = !q->base.length;
+    q->base.length -= !!q->base.length;
+    return pos;
+}
+
+
+static size_t reversePosition(DalDeque *q, size_t index) {
+    index += q->base.length * (index >= q->base.capacity);
+    q->base.error = index >= q->base.length;
+    return position(q, index);
+}
+
+
+static size_t roundPow2(size_t n) {
+    size_t pow2 = DAL_MIN_CAPACITY;
+
+    while (pow2 < n)
+        pow2 *= 2;
+
+    return pow2;
+}
+
+
+
+DAL_ERROR dal_createDeque(DalDeque *q,
+                          size_t capacity,
+                          void *(*realloc) (void *, size_t),
+                          void (*free) (void *)) {
+
+    if (!q)
+        return DAL_NULLARG;
+
+    q->head = 0;
+    return dal_createDynarrLO(&q->base, roundPow2(capacity), realloc, free);
+}
+
+
+void dal_destroyDeque(DalDeque *q) {
+    dal_destroyDynarrLO(&q->base);
+    q->head = 0;
+}
+
+
+void dal_dequeAppend(DalDeque *q, void *obj) {
+    if (growRing(q))
+        return;
+
+    q->base.error = DAL_OK;
+    q->base.array[pushBack(q)] = obj;
+}
+
+
+void dal_dequePrepend(DalDeque *q, void *obj) {
+    if (growRing(q))
+        return;
+
+    q->base.error = DAL_OK;
+    q->base.array[pushFront(q)] = obj;
+}
+
+
+void *dal_dequePop(DalDeque *q) {
+    return q->base.array[popBack(q)];
+}
+
+
+void *dal_dequePopFront(DalDeque *q) {
+    return q->base.array[popFront(q)];
+}
+
+
+void *dal_dequeGet(DalDeque *q, size_t index) {
+    q->base.error = index >= q->base.length;
+    return q->base.array[position(q, index)];
+}
+
+
+void *dal_dequeGetr(DalDeque *q, size_t index) {
+    return q->base.array[reversePosition(q, index)];
+}
+
+
+void dal_dequeWrite(DalDeque *q,
+                    size_t index,
+                    void *obj) {
+
+    q->base.error = index >= q->base.length;
+    q->base.array[position(q, index)] = obj;
+    q->base.array[q->base.capacity] = NULL;
+}
+
+
+
+#if DAL_PRIMITIVE_SUPPORT
+
+void dal_pdequeAppend(DalDeque *q, size_t val) {
+    if (growRing(q))
+        return;
+
+    q->base.error = DAL_OK;
+    q->base.arrayp[pushBack(q)] = val;
+}
+
+
+void dal_pdequePrepend(DalDeque *q, size_t val) {
+    if (growRing(q))
+        return;
+
+    q->base.error = DAL_OK;
+    q->base.arrayp[pushFront(q)] = val;
+}
+
+
+size_t dal_pdequePop(DalDeque *q) {
+    return q->base.arrayp[popBack(q)];
+}
+
+
+size_t dal_pdequePopFront(DalDeque *q) {
+    return q->base.arrayp[popFront(q)];
+}
+
+
+size_t dal_pdequeGet(DalDeque *q, size_t index) {
+    q->base.error = index >= q->base.length;
+    return q->base.arrayp[position(q, index)];
+}
+
+
+size_t dal_pdequeGetr(DalDeque *q, size_t index) {
+    return q->base.arrayp[reversePosition(q, index)];
+}
+
+
+void dal_pdequeWrite(DalDeque *q,
+                     size_t index,
+                     size_t val) {
+
+    q->base.error = index >= q->base.length;
+    q->base.arrayp[position(q, index)] = val;
+    q->base.arrayp[q->base.capacity] = 0;
+}
+
+#endif // DAL_PRIMITIVE_SUPPORT
@@ -0,0 +1,197 @@
+//
+// Created by easy on 16.10.26.
+//
+
+#ifndef EASY_DYNARRLO_DEQUE_H
+#define EASY_DYNARRLO_DEQUE_H
+
+#include "dynarrlo.h"
+
+
+/**
+ * A double-ended queue built on top of a DynarrLO. The array is used as a ring
+ * buffer whose capacity is always a power of two, so that positions wrap
+ * around with a simple mask. Elements can be added and removed at both ends in
+ * constant time, which makes a deque suitable as a FIFO queue or a sliding
+ * window.\n\n
+ *
+ * The accessor functions work branchless just like their DynarrLO
+ * counterparts. Any index >= length is redirected to the padding element, so
+ * reads return NULL / 0 and writes are discarded. When the ring is full, its
+ * capacity is doubled and the ring is unwrapped with a single copy of the
+ * shorter of its two parts.\n\n
+ *
+ * Like a DynarrLO, a deque stores either \p void* or, if available,
+ * \p size_t elements. Errors are reported through the error flag of the
+ * underlying DynarrLO \p base , which may be queried with
+ * \p dal_err(&q->base) .\n\n
+ *
+ * Do not modify \p base with the functions of DynarrLO.
+ */
+typedef struct DalDeque {
+    /**
+     * Storage of the deque. Its length is the number of elements, its capacity
+     * a power of two.
+     */
+    DynarrLO base;
+
+    /**
+     * Position of the first element in the array.
+     */
+    size_t head;
+} DalDeque;
+
+
+/**
+ * Simple accessor function to retrieve the number of elements of a deque.\n\n
+ * This function is declared \p static \p inline .
+ * @return Current amount of elements in this deque.
+ */
+static inline size_t dal_dequeLen(const DalDeque *q) {
+    return q->base.length;
+}
+
+
+/**
+ * Tries to create and allocate a deque. The capacity is rounded up to the next
+ * power of two. Does nothing on failure. See \p dal_createDynarrLO() .
+ * @param q Pointer to deque object that shall be initialised.
+ * @param capacity Desired starting capacity.
+ * @param realloc realloc function conforming to the C standard.
+ * @param free free function conforming to the C standard.
+ * @return Error code indicating either success \p(DAL_OK), a null argument
+ * error \p(DAL_NULLARG) or failure to allocate the requested amount of memory
+ * \p (DAL_ALLOCFAIL) .
+ */
+DAL_ERROR dal_createDeque(DalDeque *q,
+                          size_t capacity,
+                          void *(*realloc) (void *, size_t),
+                          void (*free) (void *));
+
+
+/**
+ * Frees the array of this deque and sets all struct fields to 0. Elements
+ * residing in the deque are not automatically freed.
+ */
+void dal_destroyDeque(DalDeque *q);
+
+
+/**
+ * Appends an object to the back of the deque. Grows the deque if needed. Error
+ * flag is set to \p DAL_ALLOCFAIL if memory couldn't be allocated.
+ * @param obj Object to append.
+ */
+void dal_dequeAppend(DalDeque *q, void *obj);
+
+
+/**
+ * Prepends an object to the front of the deque. Grows the deque if needed.
+ * Error flag is set to \p DAL_ALLOCFAIL if memory couldn't be allocated.
+ * @param obj Object to prepend.
+ */
+void dal_dequePrepend(DalDeque *q, void *obj);
+
+
+/**
+ * Removes the hindmost element and returns it. Error flag is set to
+ * \p DAL_OUTOFRANGE if deque is empty.
+ * @return Hindmost element or NULL if deque is empty.
+ */
+void *dal_dequePop(DalDeque *q);
+
+
+/**
+ * Removes the foremost element and returns it. Error flag is set to
+ * \p DAL_OUTOFRANGE if deque is empty.
+ * @return Foremost element or NULL if deque is empty.
+ */
+void *dal_dequePopFront(DalDeque *q);
+
+
+/**
+ * Gets the element at \p index , counted from the front. Error flag is set to
+ * \p DAL_OUTOFRANGE if \p index >= length.
+ * @param index Index to access.
+ * @return Element at \p index or NULL if \p index >= length.
+ */
+void *dal_dequeGet(DalDeque *q, size_t index);
+
+
+/**
+ * Gets the element at \p index. \p index may be negative, in which case -1 is
+ * the last element, -2 the penultimate one, etc. See \p dal_getr() .
+ * @param index Index to access, may be negative.
+ * @return Element at \p index after possibly converting \p index to a positive
+ * value first. NULL if resulting \p index >= length.
+ */
+void *dal_dequeGetr(DalDeque *q, size_t index);
+
+
+/**
+ * Writes an object into the deque. Does nothing if \p index >= length, in
+ * which case error flag is set to \p DAL_OUTOFRANGE.
+ * @param index Index to overwrite.
+ * @param obj Object that shall be written at the \p index.
+ */
+void dal_dequeWrite(DalDeque *q,
+                    size_t index,
+                    void *obj);
+
+
+#if DAL_PRIMITIVE_SUPPORT
+
+/**
+ * Primitive version of \p dal_dequeAppend() .
+ * @param val Value to append.
+ */
+void dal_pdequeAppend(DalDeque *q, size_t val);
+
+
+/**
+ * Primitive version of \p dal_dequePrepend() .
+ * @param val Value to prepend.
+ */
+void dal_pdequePrepend(DalDeque *q, size_t val);
+
+
+/**
+ * Primitive version of \p dal_dequePop() .
+ * @return Hindmost value or 0 if deque is empty.
+ */
+size_t dal_pdequePop(DalDeque *q);
+
+
+/**
+ * Primitive version of \p dal_dequePopFront() .
+ * @return Foremost value or 0 if deque is empty.
+ */
+size_t dal_pdequePopFront(DalDeque *q);
+
+
+/**
+ * Primitive version of \p dal_dequeGet() .
+ * @param index Index to access.
+ * @return Value at \p index or 0 if \p index >= length.
+ */
+size_t dal_pdequeGet(DalDeque *q, size_t index);
+
+
+/**
+ * Primitive version of \p dal_dequeGetr() .
+ * @param index Index to access, may be negative.
+ * @return Value at \p index or 0 if resulting \p index >= length.
+ */
+size_t dal_pdequeGetr(DalDeque *q, size_t index);
+
+
+/**
+ * Primitive version of \p dal_dequeWrite() .
+ * @param index Index to overwrite.
+ * @param val Value that shall be written at the \p index.
+ */
+void dal_pdequeWrite(DalDeque *q,
+                     size_t index,
+                     size_t val);
+
+#endif // DAL_PRIMITIVE_SUPPORT
+#endif // EASY_DYNARRLO_DEQUE_H
@@ -74,6 +74,25 @@ void squares(DynarrLO *d, int rangeStart, int rangeEnd) {
 }
 
 
+void inline_squares(DynarrLO *d, int rangeStart, int rangeEnd) {
+    // Same as squares(), but the IntSq objects live
+    // inside the array itself instead of each being
+    // allocated separately.
+
+    dal_createDynarrLOSized(d, 0, sizeof(IntSq), realloc, free);
+
+    for (int i = rangeStart; i < rangeEnd; ++i) {
+        IntSq isq = {i, i * i};
+        dal_sappend(d, &isq);
+    }
+
+    // Elements can also be constructed in place
+    IntSq *isq = dal_sappend(d, NULL);
+    isq->n = rangeEnd;
+    isq->n2 = rangeEnd * rangeEnd;
+}
+
+
 void errors(DynarrLO *d) {
     dal_createDynarrLO(d, 5, realloc, free);
 
@@ -176,4 +195,18 @@ int main(void) {
 
     // Example 4
     errors(&d);
+    printf("\n\n");
+
+
+
+    // Example 5
+    inline_squares(&d, 0, 5);
+    puts("Some squares stored inline:");
+
+    for (size_t i = 0; i < dal_len(&d); ++i) {
+        IntSq *isq = dal_sget(&d, i);
+        printf("(%i)² = %i\n", isq->n, isq->n2);
+    }
+
+    dal_destroyDynarrLO(&d);
 }
@@ -0,0 +1,215 @@
+//
+// Created by easy on 16.10.26.
+//
+
+
+#include "dynarrlo_gap.h"
+#include <stdbool.h>
+#include <string.h>
+
+
+// Returns the lesser of the two arguments.
+#define MIN(a, b) ((a) <= (b) ? (a) : (b))
+
+
+static size_t itemsToBytes(size_t n) {
+    return n * sizeof(void *);
+}
+
+
+static size_t gapLength(const DalGapBuffer *g) {
+    return g->base.capacity - g->base.length;
+}
+
+
+/**
+ * Translates an index into a position in the array. Indices behind the gap are
+ * displaced by its length. Any index >= length is first clamped to length,
+ * which the gap displaces to capacity, the padding element. Clamping first
+ * keeps huge indices from wrapping around when the gap is added.
+ */
+static size_t position(const DalGapBuffer *g, size_t index) {
+    index = MIN(index, g->base.length);
+    return index + gapLength(g) * (index >= g->gapStart);
+}
+
+
+/**
+ * Moves the gap so that it begins at index. Only the elements between the old
+ * and the new position of the gap are moved.
+ */
+static void moveGap(DalGapBuffer *g, size_t index) {
+    void **array = g->base.array;
+    size_t gap = gapLength(g);
+
+    if (index < g->gapStart)
+        memmove(array + index + gap,
+                array + index,
+                itemsToBytes(g->gapStart - index));
+    else
+        memmove(array + g->gapStart,
+                array + g->gapStart + gap,
+                itemsToBytes(index - g->gapStart));
+
+    g->gapStart = index;
+}
+
+
+/**
+ * Grows the array if the gap is empty. The elements behind the gap are moved
+ * to the end of the grown array, so that the new space becomes the gap.
+ * @return True iff memory allocation failed.
+ */
+static bool growGap(DalGapBuffer *g) {
+    DynarrLO *d = &g->base;
+    size_t capacity = d->capacity;
+
+    if (d->length < capacity)
+        return false;
+
+    dal_reserve(d, d->length + 1);
+    if (d->error)
+        return true;
+
+    memmove(d->array + g->gapStart + (d->capacity - capacity),
+            d->array + g->gapStart,
+            itemsToBytes(capacity - g->gapStart));
+
+    return false;
+}
+
+
+/**
+ * Moves the gap to index and makes room for one element at its beginning.
+ * @return True iff nothing may be inserted.
+ */
+static bool openGap(DalGapBuffer *g, size_t index) {
+    DAL_ERROR error = index > g->base.length;
+    g->base.error = error;
+
+    if (error || growGap(g))
+        return true;
+
+    moveGap(g, index);
+    return false;
+}
+
+
+
+DAL_ERROR dal_createGapBuffer(DalGapBuffer *g,
+                              size_t capacity,
+                              void *(*realloc) (void *, size_t),
+                              void (*free) (void *)) {
+
+    if (!g)
+        return DAL_NULLARG;
+
+    g->gapStart = 0;
+    return dal_createDynarrLO(&g->base, capacity, realloc, free);
+}
+
+
+void dal_destroyGapBuffer(DalGapBuffer *g) {
+    dal_destroyDynarrLO(&g->base);
+    g->gapStart = 0;
+}
+
+
+DalSpan dal_gapClose(DalGapBuffer *g) {
+    moveGap(g, g->base.length);
+    return dal_data(&g->base);
+}
+
+
+void dal_gapInsert(DalGapBuffer *g,
+                   size_t index,
+                   void *obj) {
+
+    if (openGap(g, index))
+        return;
+
+    g->base.array[g->gapStart++] = obj;
+    ++g->base.length;
+}
+
+
+void dal_gapAppend(DalGapBuffer *g, void *obj) {
+    dal_gapInsert(g, g->base.length, obj);
+}
+
+
+void dal_gapRemove(DalGapBuffer *g, size_t index) {
+    if ((g->base.error = index >= g->base.length))
+        return;
+
+    moveGap(g, index);
+    --g->base.length;
+}
+
+
+void dal_gapRemoveMany(DalGapBuffer *g,
+                       size_t iStart,
+                       size_t iEnd) {
+
+    DynarrLO *d = &g->base;
+    d->error = (iStart >= d->length) | (iEnd > d->length);
+    iEnd = MIN(iEnd, d->length);
+    iStart = MIN(iStart, iEnd);
+
+    moveGap(g, iStart);
+    d->length -= iEnd - iStart;
+}
+
+
+void *dal_gapGet(DalGapBuffer *g, size_t index) {
+    g->base.error = index >= g->base.length;
+    return g->base.array[position(g, index)];
+}
+
+
+void dal_gapWrite(DalGapBuffer *g,
+                  size_t index,
+                  void *obj) {
+
+    g->base.error = index >= g->base.length;
+    g->base.array[position(g, index)] = obj;
+    g->base.array[g->base.capacity] = NULL;
+}
+
+
+
+#if DAL_PRIMITIVE_SUPPORT
+
+void dal_pgapInsert(DalGapBuffer *g,
+                    size_t index,
+                    size_t val) {
+
+    if (openGap(g, index))
+        return;
+
+    g->base.arrayp[g->gapStart++] = val;
+    ++g->base.length;
+}
+
+
+void dal_pgapAppend(DalGapBuffer *g, size_t val) {
+    dal_pgapInsert(g, g->base.length, val);
+}
+
+
+size_t dal_pgapGet(DalGapBuffer *g, size_t index) {
+    g->base.error = index >= g->base.length;
+    return g->base.arrayp[position(g, index)];
+}
+
+
+void dal_pgapWrite(DalGapBuffer *g,
+                   size_t index,
+                   size_t val) {
+
+    g->base.error = index >= g->base.length;
+    g->base.arrayp[position(g, index)] = val;
+    g->base.arrayp[g->base.capacity] = 0;
+}
+
+#endif // DAL_PRIMITIVE_SUPPORT
@@ -0,0 +1,188 @@
+//
+// Created by easy on 16.10.26.
+//
+
+#ifndef EASY_DYNARRLO_GAP_H
+#define EASY_DYNARRLO_GAP_H
+
+#include "dynarrlo.h"
+
+
+/**
+ * A gap buffer built on top of a DynarrLO. All unused capacity of the array
+ * forms a single gap that is moved lazily to wherever elements are inserted or
+ * removed. Inserting or removing elements close to the previous edit position
+ * hence only moves as many elements as the distance between the two positions,
+ * instead of the whole tail of the array.\n\n
+ *
+ * Elements before the gap lie at their index in the array, elements behind it
+ * are displaced by the size of the gap. The accessor functions translate
+ * indices across the gap without branching. \p dal_gapClose() moves the gap
+ * to the end of the array, after which the elements are contiguous again.\n\n
+ *
+ * Like a DynarrLO, a gap buffer stores either \p void* or, if available,
+ * \p size_t elements and keeps a padding element behind its capacity. Errors
+ * are reported through the error flag of the underlying DynarrLO \p base ,
+ * which may be queried with \p dal_err(&g->base) .\n\n
+ *
+ * Do not modify \p base with the functions of DynarrLO.
+ */
+typedef struct DalGapBuffer {
+    /**
+     * Storage of the gap buffer. Its length is the number of elements, the gap
+     * spans capacity - length elements.
+     */
+    DynarrLO base;
+
+    /**
+     * Index at which the gap begins.
+     */
+    size_t gapStart;
+} DalGapBuffer;
+
+
+/**
+ * Simple accessor function to retrieve the number of elements of a gap buffer.
+ * \n\n
+ * This function is declared \p static \p inline .
+ * @return Current amount of elements in this gap buffer.
+ */
+static inline size_t dal_gapLen(const DalGapBuffer *g) {
+    return g->base.length;
+}
+
+
+/**
+ * Tries to create and allocate a gap buffer. Does nothing on failure.
+ * See \p dal_createDynarrLO() .
+ * @param g Pointer to gap buffer object that shall be initialised.
+ * @param capacity Desired starting capacity.
+ * @param realloc realloc function conforming to the C standard.
+ * @param free free function conforming to the C standard.
+ * @return Error code indicating either success \p(DAL_OK), a null argument
+ * error \p(DAL_NULLARG) or failure to allocate the requested amount of memory
+ * \p (DAL_ALLOCFAIL) .
+ */
+DAL_ERROR dal_createGapBuffer(DalGapBuffer *g,
+                              size_t capacity,
+                              void *(*realloc) (void *, size_t),
+                              void (*free) (void *));
+
+
+/**
+ * Frees the array of this gap buffer and sets all struct fields to 0.
+ */
+void dal_destroyGapBuffer(DalGapBuffer *g);
+
+
+/**
+ * Moves the gap to the end of the array, making all elements contiguous, and
+ * returns them. Use this before bulk scans over the elements. The gap is moved
+ * back lazily by the next insertion or removal.
+ * @return Span of all elements. Valid until the gap buffer is modified.
+ */
+DalSpan dal_gapClose(DalGapBuffer *g);
+
+
+/**
+ * Inserts an element at \p index , moving the gap there first. Grows the array
+ * if needed. Error flag is set to \p DAL_OUTOFRANGE if \p index > length, in
+ * which case nothing is done, or to \p DAL_ALLOCFAIL if memory couldn't be
+ * allocated.
+ * @param index Index object should assume.
+ * @param obj Object to insert.
+ */
+void dal_gapInsert(DalGapBuffer *g,
+                   size_t index,
+                   void *obj);
+
+
+/**
+ * Same as \p dal_gapInsert() with \p index equal to length.
+ * @param obj Object to append.
+ */
+void dal_gapAppend(DalGapBuffer *g, void *obj);
+
+
+/**
+ * Removes the element at \p index by moving the gap there and widening it.
+ * Does nothing if \p index >= length, in which case error flag is set to
+ * \p DAL_OUTOFRANGE.
+ * @param index Index of element to remove.
+ */
+void dal_gapRemove(DalGapBuffer *g, size_t index);
+
+
+/**
+ * Removes the elements in [ \p iStart , \p iEnd ) by moving the gap there and
+ * widening it. Error flag is set to \p DAL_OUTOFRANGE if \p iStart >= length
+ * or \p iEnd > length.
+ * @param iStart Index at which removal begins (inclusive). Automatically set to
+ * the final value of \p iEnd if it exceeds the final value of \p iEnd.
+ * @param iEnd Index at which removal ends (exclusive). Automatically set to
+ * length if it exceeds the value of length.
+ */
+void dal_gapRemoveMany(DalGapBuffer *g,
+                       size_t iStart,
+                       size_t iEnd);
+
+
+/**
+ * Gets the element at \p index. Does not move the gap. Error flag is set to
+ * \p DAL_OUTOFRANGE if \p index >= length.
+ * @param index Index to access.
+ * @return Element at \p index or NULL if \p index >= length.
+ */
+void *dal_gapGet(DalGapBuffer *g, size_t index);
+
+
+/**
+ * Writes an object into the gap buffer. Does not move the gap. Does nothing
+ * if \p index >= length, in which case error flag is set to
+ * \p DAL_OUTOFRANGE.
+ * @param index Index to overwrite.
+ * @param obj Object that shall be written at the \p index.
+ */
+void dal_gapWrite(DalGapBuffer *g,
+                  size_t index,
+                  void *obj);
+
+
+#if DAL_PRIMITIVE_SUPPORT
+
+/**
+ * Primitive version of \p dal_gapInsert() .
+ * @param index Index value should assume.
+ * @param val Value to insert.
+ */
+void dal_pgapInsert(DalGapBuffer *g,
+                    size_t index,
+                    size_t val);
+
+
+/**
+ * Primitive version of \p dal_gapAppend() .
+ * @param val Value to append.
+ */
+void dal_pgapAppend(DalGapBuffer *g, size_t val);
+
+
+/**
+ * Primitive version of \p dal_gapGet() .
+ * @param index Index to access.
+ * @return Value at \p index or 0 if \p index >= length.
+ */
+size_t dal_pgapGet(DalGapBuffer *g, size_t index);
+
+
+/**
+ * Primitive version of \p dal_gapWrite() .
+ * @param index Index to overwrite.
+ * @param val Value that shall be written at the \p index.
+ */
+void dal_pgapWrite(DalGapBuffer *g,
+                   size_t index,
+                   size_t val);
+
+#endif // DAL_PRIMITIVE_SUPPORT
+#endif // EASY_DYNARRLO_GAP_H
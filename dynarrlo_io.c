@@ -0,0 +1,799 @@
+//
+// Created by easy on 16.10.26.
+//
+
+#define _DEFAULT_SOURCE
+
+#include "dynarrlo_io.h"
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define IO_X86 1
+#else
+#define IO_X86 0
+#endif
+
+
+// Returns the lesser of the two arguments.
+#define MIN(a, b) ((a) <= (b) ? (a) : (b))
+// Returns the greater of the two arguments.
+#define MAX(a, b) ((a) >= (b) ? (a) : (b))
+
+// "DALSTREM" in little endian, so streams of the other byte order are rejected
+#define STREAM_MAGIC 0x4d455254534c4144u
+#define STREAM_VERSION 1
+
+// Number of iovecs passed to a single writev() or readv() call.
+#if defined(IOV_MAX) && IOV_MAX < 64
+#define IOVECS IOV_MAX
+#else
+#define IOVECS 64
+#endif
+
+// Size of the buffer that encoded chunks are batched in.
+#define BUFFER_SIZE (8 * DAL_IO_CHUNK)
+
+// Longest variable-length encoding of a size_t.
+#define MAX_VARINT ((sizeof(size_t) * CHAR_BIT + 6) / 7)
+
+// Size of the length in front of every encoded object.
+#define OBJECT_PREFIX sizeof(uint32_t)
+
+
+enum Encoding {
+    RAW,
+    DELTA,
+    OBJECTS
+};
+
+
+/**
+ * Header at the start of a stream.
+ */
+typedef struct StreamHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t encoding;
+    uint32_t wordSize;      // sizeof(size_t) of the writer
+    uint32_t crc;           // Of the header with this field set to 0
+    uint64_t elemSize;
+    uint64_t length;
+    uint64_t chunkLength;   // Elements per chunk, 0 for objects
+} StreamHeader;
+
+
+/**
+ * Header in front of the bytes of every chunk.
+ */
+typedef struct ChunkHeader {
+    uint32_t length;        // Elements
+    uint32_t size;          // Bytes
+    uint32_t crc;
+    uint32_t padding;
+} ChunkHeader;
+
+
+/**
+ * Collects chunks and writes them in batches. The bytes of a queued chunk must
+ * stay untouched until the batch has been written.
+ */
+typedef struct Writer {
+    int fd;
+    int queued;
+    struct iovec iov[IOVECS];
+    ChunkHeader heads[IOVECS / 2];
+
+    // Buffer for encoded chunks
+    unsigned char *buf;
+    size_t used;
+    size_t size;
+
+    void *(*realloc) (void *, size_t);
+    void (*free) (void *);
+    DAL_ERROR error;
+} Writer;
+
+
+/**
+ * State of decoding the chunks of a stream.
+ */
+typedef struct Decoder {
+    size_t prev;            // Last value of a delta encoded stream
+    size_t decoded;         // Number of objects decoded so far
+    DalDecodeFn decode;
+    void *ctx;
+} Decoder;
+
+
+
+// CRC-32C (Castagnoli) lookup table, reflected polynomial 0x82f63b78.
+static const uint32_t crcTable[256] = {
+    0x00000000, 0xf26b8303, 0xe13b70f7, 0x1350f3f4, 0xc79a971f, 0x35f1141c,
+    0x26a1e7e8, 0xd4ca64eb, 0x8ad958cf, 0x78b2dbcc, 0x6be22838, 0x9989ab3b,
+    0x4d43cfd0, 0xbf284cd3, 0xac78bf27, 0x5e133c24, 0x105ec76f, 0xe235446c,
+    0xf165b798, 0x030e349b, 0xd7c45070, 0x25afd373, 0x36ff2087, 0xc494a384,
+    0x9a879fa0, 0x68ec1ca3, 0x7bbcef57, 0x89d76c54, 0x5d1d08bf, 0xaf768bbc,
+    0xbc267848, 0x4e4dfb4b, 0x20bd8ede, 0xd2d60ddd, 0xc186fe29, 0x33ed7d2a,
+    0xe72719c1, 0x154c9ac2, 0x061c6936, 0xf477ea35, 0xaa64d611, 0x580f5512,
+    0x4b5fa6e6, 0xb93425e5, 0x6dfe410e, 0x9f95c20d, 0x8cc531f9, 0x7eaeb2fa,
+    0x30e349b1, 0xc288cab2, 0xd1d83946, 0x23b3ba45, 0xf779deae, 0x05125dad,
+    0x1642ae59, 0xe4292d5a, 0xba3a117e, 0x4851927d, 0x5b016189, 0xa96ae28a,
+    0x7da08661, 0x8fcb0562, 0x9c9bf696, 0x6ef07595, 0x417b1dbc, 0xb3109ebf,
+    0xa0406d4b, 0x522bee48, 0x86e18aa3, 0x748a09a0, 0x67dafa54, 0x95b17957,
+    0xcba24573, 0x39c9c670, 0x2a993584, 0xd8f2b687, 0x0c38d26c, 0xfe53516f,
+    0xed03a29b, 0x1f682198, 0x5125dad3, 0xa34e59d0, 0xb01eaa24, 0x42752927,
+    0x96bf4dcc, 0x64d4cecf, 0x77843d3b, 0x85efbe38, 0xdbfc821c, 0x2997011f,
+    0x3ac7f2eb, 0xc8ac71e8, 0x1c661503, 0xee0d9600, 0xfd5d65f4, 0x0f36e6f7,
+    0x61c69362, 0x93ad1061, 0x80fde395, 0x72966096, 0xa65c047d, 0x5437877e,
+    0x4767748a, 0xb50cf789, 0xeb1fcbad, 0x197448ae, 0x0a24bb5a, 0xf84f3859,
+    0x2c855cb2, 0xdeeedfb1, 0xcdbe2c45, 0x3fd5af46, 0x7198540d, 0x83f3d70e,
+    0x90a324fa, 0x62c8a7f9, 0xb602c312, 0x44694011, 0x5739b3e5, 0xa55230e6,
+    0xfb410cc2, 0x092a8fc1, 0x1a7a7c35, 0xe811ff36, 0x3cdb9bdd, 0xceb018de,
+    0xdde0eb2a, 0x2f8b6829, 0x82f63b78, 0x709db87b, 0x63cd4b8f, 0x91a6c88c,
+    0x456cac67, 0xb7072f64, 0xa457dc90, 0x563c5f93, 0x082f63b7, 0xfa44e0b4,
+    0xe9141340, 0x1b7f9043, 0xcfb5f4a8, 0x3dde77ab, 0x2e8e845f, 0xdce5075c,
+    0x92a8fc17, 0x60c37f14, 0x73938ce0, 0x81f80fe3, 0x55326b08, 0xa759e80b,
+    0xb4091bff, 0x466298fc, 0x1871a4d8, 0xea1a27db, 0xf94ad42f, 0x0b21572c,
+    0xdfeb33c7, 0x2d80b0c4, 0x3ed04330, 0xccbbc033, 0xa24bb5a6, 0x502036a5,
+    0x4370c551, 0xb11b4652, 0x65d122b9, 0x97baa1ba, 0x84ea524e, 0x7681d14d,
+    0x2892ed69, 0xdaf96e6a, 0xc9a99d9e, 0x3bc21e9d, 0xef087a76, 0x1d63f975,
+    0x0e330a81, 0xfc588982, 0xb21572c9, 0x407ef1ca, 0x532e023e, 0xa145813d,
+    0x758fe5d6, 0x87e466d5, 0x94b49521, 0x66df1622, 0x38cc2a06, 0xcaa7a905,
+    0xd9f75af1, 0x2b9cd9f2, 0xff56bd19, 0x0d3d3e1a, 0x1e6dcdee, 0xec064eed,
+    0xc38d26c4, 0x31e6a5c7, 0x22b65633, 0xd0ddd530, 0x0417b1db, 0xf67c32d8,
+    0xe52cc12c, 0x1747422f, 0x49547e0b, 0xbb3ffd08, 0xa86f0efc, 0x5a048dff,
+    0x8ecee914, 0x7ca56a17, 0x6ff599e3, 0x9d9e1ae0, 0xd3d3e1ab, 0x21b862a8,
+    0x32e8915c, 0xc083125f, 0x144976b4, 0xe622f5b7, 0xf5720643, 0x07198540,
+    0x590ab964, 0xab613a67, 0xb831c993, 0x4a5a4a90, 0x9e902e7b, 0x6cfbad78,
+    0x7fab5e8c, 0x8dc0dd8f, 0xe330a81a, 0x115b2b19, 0x020bd8ed, 0xf0605bee,
+    0x24aa3f05, 0xd6c1bc06, 0xc5914ff2, 0x37faccf1, 0x69e9f0d5, 0x9b8273d6,
+    0x88d28022, 0x7ab90321, 0xae7367ca, 0x5c18e4c9, 0x4f48173d, 0xbd23943e,
+    0xf36e6f75, 0x0105ec76, 0x12551f82, 0xe03e9c81, 0x34f4f86a, 0xc69f7b69,
+    0xd5cf889d, 0x27a40b9e, 0x79b737ba, 0x8bdcb4b9, 0x988c474d, 0x6ae7c44e,
+    0xbe2da0a5, 0x4c4623a6, 0x5f16d052, 0xad7d5351
+};
+
+
+static uint32_t crcScalar(uint32_t crc, const unsigned char *p, size_t n) {
+    while (n--)
+        crc = crcTable[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+
+    return crc;
+}
+
+
+static uint32_t (*crcKernel) (uint32_t, const unsigned char *, size_t) =
+        crcScalar;
+
+
+#if IO_X86
+
+__attribute__((target("sse4.2")))
+static uint32_t crcSSE42(uint32_t crc, const unsigned char *p, size_t n) {
+    uint64_t c = crc;
+
+    for (; n >= 8; n -= 8, p += 8) {
+        uint64_t word;
+        memcpy(&word, p, sizeof word);
+        c = __builtin_ia32_crc32di(c, word);
+    }
+
+    crc = (uint32_t) c;
+
+    while (n--)
+        crc = __builtin_ia32_crc32qi(crc, *p++);
+
+    return crc;
+}
+
+
+// Picks the hardware CRC once when the program is loaded.
+__attribute__((constructor)) static void selectCrc(void) {
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("sse4.2"))
+        crcKernel = crcSSE42;
+}
+
+#endif // IO_X86
+
+
+static uint32_t checksum(const void *data, size_t n) {
+    return ~crcKernel(~(uint32_t) 0, data, n);
+}
+
+
+
+/**
+ * Writes all iovecs, continuing after partial writes and interruptions.
+ * @return False iff writing failed.
+ */
+static bool writeAll(int fd, struct iovec *iov, int n) {
+    while (n) {
+        ssize_t done = writev(fd, iov, n);
+
+        if (done < 0 && errno == EINTR)
+            continue;
+
+        if (done < 0)
+            return false;
+
+        size_t left = (size_t) done;
+
+        for (; n && left >= iov->iov_len; ++iov, --n)
+            left -= iov->iov_len;
+
+        if (n && !done)
+            return false;
+
+        if (n) {
+            iov->iov_base = (unsigned char *) iov->iov_base + left;
+            iov->iov_len -= left;
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * Fills all iovecs, continuing after partial reads and interruptions.
+ * @return False iff reading failed or the stream ended early.
+ */
+static bool readAll(int fd, struct iovec *iov, int n) {
+    while (n) {
+        ssize_t done = readv(fd, iov, n);
+
+        if (done < 0 && errno == EINTR)
+            continue;
+
+        if (done < 0)
+            return false;
+
+        size_t left = (size_t) done;
+
+        for (; n && left >= iov->iov_len; ++iov, --n)
+            left -= iov->iov_len;
+
+        if (n && !done)
+            return false;
+
+        if (n) {
+            iov->iov_base = (unsigned char *) iov->iov_base + left;
+            iov->iov_len -= left;
+        }
+    }
+
+    return true;
+}
+
+
+
+// Number of elements in a chunk of a raw or delta encoded stream.
+static size_t chunkLength(size_t elemSize) {
+    return MAX(MIN(DAL_IO_CHUNK, UINT32_MAX) / elemSize, 1);
+}
+
+
+/**
+ * Starts a stream by queueing its header, which must stay untouched until the
+ * writer is done.
+ */
+static void begin(Writer *w,
+                  StreamHeader *h,
+                  const DynarrLO *d,
+                  int fd,
+                  uint32_t encoding,
+                  size_t chunk) {
+
+    *w = (Writer) {.fd = fd, .realloc = d->realloc, .free = d->free};
+    *h = (StreamHeader) {STREAM_MAGIC, STREAM_VERSION, encoding,
+                         sizeof(size_t), 0, d->elemSize, d->length, chunk};
+    h->crc = checksum(h, sizeof *h);
+    w->iov[w->queued++] = (struct iovec) {h, sizeof *h};
+
+    if (d->elemSize * chunk > UINT32_MAX)
+        w->error = DAL_IOFAIL;
+}
+
+
+// Writes all queued chunks and empties the buffer.
+static void flush(Writer *w) {
+    if (!w->error && w->queued && !writeAll(w->fd, w->iov, w->queued))
+        w->error = DAL_IOFAIL;
+
+    w->queued = 0;
+    w->used = 0;
+}
+
+
+// Writes what is left, frees the buffer and reports the first error.
+static DAL_ERROR end(Writer *w) {
+    flush(w);
+    w->free(w->buf);
+    return w->error;
+}
+
+
+static void putChunk(Writer *w, size_t length, const void *data, size_t size) {
+    if (w->queued + 2 > IOVECS)
+        flush(w);
+
+    ChunkHeader *h = w->heads + w->queued / 2;
+    *h = (ChunkHeader) {(uint32_t) length, (uint32_t) size,
+                        checksum(data, size), 0};
+
+    w->iov[w->queued++] = (struct iovec) {h, sizeof *h};
+    w->iov[w->queued++] = (struct iovec) {(void *) data, size};
+}
+
+
+/**
+ * Gets room for encoding a chunk of up to size bytes at the end of the buffer.
+ * Writes the queued chunks first if the buffer is too full or no iovec is left
+ * for the chunk, so that queueing it never empties the buffer it lies in.
+ * @return Room for the chunk or NULL if the buffer couldn't be grown.
+ */
+static unsigned char *room(Writer *w, size_t size) {
+    if (w->queued + 2 > IOVECS)
+        flush(w);
+
+    if (w->used + size <= w->size)
+        return w->buf + w->used;
+
+    flush(w);
+
+    if (size > w->size) {
+        size_t grown = MAX(size, BUFFER_SIZE);
+        unsigned char *buf = w->realloc(w->buf, grown);
+
+        if (!buf) {
+            w->error = DAL_ALLOCFAIL;
+            return NULL;
+        }
+
+        w->buf = buf;
+        w->size = grown;
+    }
+
+    return w->buf;
+}
+
+
+// Queues the chunk encoded at the end of the buffer.
+static void putEncoded(Writer *w, size_t length, size_t size) {
+    unsigned char *chunk = w->buf + w->used;
+    w->used += size;
+    putChunk(w, length, chunk, size);
+}
+
+
+
+// Reads and checks the header of a stream.
+static DAL_ERROR readHeader(int fd, StreamHeader *h) {
+    struct iovec iov = {h, sizeof *h};
+
+    if (!readAll(fd, &iov, 1))
+        return DAL_IOFAIL;
+
+    uint32_t crc = h->crc;
+    h->crc = 0;
+
+    bool valid = h->magic == STREAM_MAGIC && h->version == STREAM_VERSION &&
+                 h->wordSize == sizeof(size_t) &&
+                 crc == checksum(h, sizeof *h) && h->elemSize &&
+                 h->length < SIZE_MAX / h->elemSize - 1;
+
+    if (!valid)
+        return DAL_IOFAIL;
+
+    switch (h->encoding) {
+        case RAW:
+            valid &= h->chunkLength &&
+                     h->chunkLength <= UINT32_MAX / h->elemSize;
+            break;
+#if DAL_PRIMITIVE_SUPPORT
+        case DELTA:
+            valid &= h->elemSize == sizeof(size_t) && h->chunkLength &&
+                     h->chunkLength <= UINT32_MAX;
+            break;
+#endif
+        case OBJECTS:
+            valid &= h->elemSize == sizeof(void *);
+            break;
+        default:
+            valid = false;
+    }
+
+    return valid ? DAL_OK : DAL_IOFAIL;
+}
+
+
+/**
+ * Reads the chunks of a raw stream straight into the array, many chunks per
+ * readv() call, and checks them afterwards.
+ */
+static DAL_ERROR loadRaw(int fd, const StreamHeader *h, unsigned char *data) {
+    size_t chunk = h->chunkLength;
+    struct iovec iov[IOVECS];
+    ChunkHeader heads[IOVECS / 2];
+
+    for (size_t i = 0; i < h->length;) {
+        size_t first = i;
+        int n = 0;
+
+        for (; n + 2 <= IOVECS && i < h->length; i += chunk, n += 2) {
+            size_t length = MIN(chunk, h->length - i);
+            iov[n] = (struct iovec) {heads + n / 2, sizeof *heads};
+            iov[n + 1] = (struct iovec) {data + i * h->elemSize,
+                                         length * h->elemSize};
+        }
+
+        if (!readAll(fd, iov, n))
+            return DAL_IOFAIL;
+
+        for (int k = 0; k < n / 2; ++k, first += chunk) {
+            size_t length = MIN(chunk, h->length - first);
+            const ChunkHeader *c = heads + k;
+
+            if (c->length != length || c->size != length * h->elemSize ||
+                c->crc != checksum(data + first * h->elemSize, c->size))
+                return DAL_IOFAIL;
+        }
+    }
+
+    return DAL_OK;
+}
+
+
+static DAL_ERROR decodeObjects(Decoder *dec,
+                               const unsigned char *p,
+                               const unsigned char *end,
+                               size_t length,
+                               void **out) {
+
+    for (size_t j = 0; j < length; ++j) {
+        uint32_t size;
+
+        if ((size_t) (end - p) < OBJECT_PREFIX)
+            return DAL_IOFAIL;
+
+        memcpy(&size, p, OBJECT_PREFIX);
+        p += OBJECT_PREFIX;
+
+        if (size > (size_t) (end - p))
+            return DAL_IOFAIL;
+
+        DAL_ERROR error = dec->decode(p, size, out + j, dec->ctx);
+        if (error)
+            return error;
+
+        ++dec->decoded;
+        p += size;
+    }
+
+    return p == end ? DAL_OK : DAL_IOFAIL;
+}
+
+
+#if DAL_PRIMITIVE_SUPPORT
+
+static size_t putVarint(unsigned char *p, size_t val) {
+    size_t n = 0;
+
+    for (; val >= 0x80; val >>= 7)
+        p[n++] = (unsigned char) (val | 0x80);
+
+    p[n++] = (unsigned char) val;
+    return n;
+}
+
+
+/**
+ * Reads a variable-length integer and advances p past it.
+ * @return False iff the integer is cut off or too long.
+ */
+static bool getVarint(const unsigned char **p,
+                      const unsigned char *end,
+                      size_t *val) {
+
+    size_t v = 0;
+
+    for (unsigned shift = 0;
+         *p < end && shift < sizeof(size_t) * CHAR_BIT;
+         shift += 7) {
+
+        unsigned char byte = *(*p)++;
+        v |= (size_t) (byte & 0x7f) << shift;
+
+        if (!(byte & 0x80)) {
+            *val = v;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+static DAL_ERROR decodeDeltas(Decoder *dec,
+                              const unsigned char *p,
+                              const unsigned char *end,
+                              size_t length,
+                              size_t *out) {
+
+    for (size_t j = 0; j < length; ++j) {
+        size_t delta;
+
+        if (!getVarint(&p, end, &delta))
+            return DAL_IOFAIL;
+
+        dec->prev += delta;
+        out[j] = dec->prev;
+    }
+
+    return p == end ? DAL_OK : DAL_IOFAIL;
+}
+
+#endif // DAL_PRIMITIVE_SUPPORT
+
+
+/**
+ * Reads and decodes the chunks of an encoded stream one by one. Every readv()
+ * call reads the bytes of a chunk together with the header of the next one.
+ */
+static DAL_ERROR loadEncoded(int fd,
+                             const StreamHeader *h,
+                             Decoder *dec,
+                             void **out,
+                             void *(*realloc) (void *, size_t),
+                             void (*free) (void *)) {
+
+    unsigned char *buf = NULL;
+    size_t size = 0;
+    ChunkHeader c;
+    struct iovec iov[2] = {{&c, sizeof c}};
+    DAL_ERROR error = DAL_OK;
+
+    if (h->length && !readAll(fd, iov, 1))
+        return DAL_IOFAIL;
+
+    for (size_t i = 0; i < h->length && !error;) {
+        ChunkHeader chunk = c;
+
+        if (!chunk.length || chunk.length > h->length - i) {
+            error = DAL_IOFAIL;
+            break;
+        }
+
+        if (chunk.size > size) {
+            unsigned char *grown = realloc(buf, chunk.size);
+
+            if (!grown) {
+                error = DAL_ALLOCFAIL;
+                break;
+            }
+
+            buf = grown;
+            size = chunk.size;
+        }
+
+        // The last chunk is not followed by another header
+        iov[0] = (struct iovec) {buf, chunk.size};
+        iov[1] = (struct iovec) {&c, sizeof c};
+
+        if (!readAll(fd, iov, 1 + (i + chunk.length < h->length)) ||
+            chunk.crc != checksum(buf, chunk.size)) {
+            error = DAL_IOFAIL;
+            break;
+        }
+
+        const unsigned char *end = buf + chunk.size;
+
+#if DAL_PRIMITIVE_SUPPORT
+        if (h->encoding == DELTA)
+            error = decodeDeltas(dec, buf, end, chunk.length,
+                                 (size_t *) out + i);
+        else
+#endif
+            error = decodeObjects(dec, buf, end, chunk.length, out + i);
+
+        i += chunk.length;
+    }
+
+    free(buf);
+    return error;
+}
+
+
+
+DAL_ERROR dal_save(const DynarrLO *d, int fd) {
+    Writer w;
+    StreamHeader h;
+    size_t chunk = chunkLength(d->elemSize);
+    const unsigned char *data = (const unsigned char *) d->array;
+
+    begin(&w, &h, d, fd, RAW, chunk);
+
+    for (size_t i = 0; i < d->length && !w.error; i += chunk) {
+        size_t length = MIN(chunk, d->length - i);
+        putChunk(&w, length, data + i * d->elemSize, length * d->elemSize);
+    }
+
+    return end(&w);
+}
+
+
+DAL_ERROR dal_saveObjects(const DynarrLO *d,
+                          int fd,
+                          DalEncodeFn encode,
+                          void *ctx) {
+
+    if (!encode)
+        return DAL_NULLARG;
+
+    Writer w;
+    StreamHeader h;
+    unsigned char *chunk = NULL;
+    size_t size = 0;
+    size_t length = 0;
+    size_t needed = DAL_IO_CHUNK;
+
+    begin(&w, &h, d, fd, OBJECTS, 0);
+
+    for (size_t i = 0; i < d->length && !w.error;) {
+        if (!chunk && !(chunk = room(&w, needed)))
+            break;
+
+        // The room of a chunk reaches up to the end of the buffer
+        size_t left = w.size - w.used - size;
+        size_t encoded = 0;
+        bool fits = left > OBJECT_PREFIX &&
+                    (encoded = encode(d->array[i], chunk + size + OBJECT_PREFIX,
+                                      left - OBJECT_PREFIX, ctx)) <=
+                    left - OBJECT_PREFIX;
+
+        if (fits) {
+            uint32_t prefix = (uint32_t) encoded;
+            memcpy(chunk + size, &prefix, OBJECT_PREFIX);
+            size += OBJECT_PREFIX + encoded;
+            ++length;
+            ++i;
+
+            if (size < DAL_IO_CHUNK && i < d->length && length < UINT32_MAX)
+                continue;
+        } else if (!length) {
+            if (encoded > UINT32_MAX - OBJECT_PREFIX) {
+                w.error = DAL_IOFAIL;
+                break;
+            }
+
+            // A single object that doesn't fit, get more room and try again
+            chunk = NULL;
+            needed = OBJECT_PREFIX + encoded;
+            continue;
+        }
+
+        putEncoded(&w, length, size);
+        chunk = NULL;
+        size = 0;
+        length = 0;
+        needed = DAL_IO_CHUNK;
+    }
+
+    return end(&w);
+}
+
+
+DAL_ERROR dal_load(DynarrLO *d,
+                   int fd,
+                   void *(*realloc) (void *, size_t),
+                   void (*free) (void *)) {
+
+    if (!d || !realloc || !free)
+        return DAL_NULLARG;
+
+    StreamHeader h;
+    DynarrLO tmp;
+    DAL_ERROR error = readHeader(fd, &h);
+
+    if (error || h.encoding == OBJECTS)
+        return DAL_IOFAIL;
+
+    error = dal_createDynarrLOSized(&tmp, h.length, h.elemSize, realloc, free);
+    if (error)
+        return error;
+
+    Decoder dec = {0};
+    unsigned char *data = dal_appendUninit(&tmp, h.length);
+
+    error = h.encoding == RAW ?
+            loadRaw(fd, &h, data) :
+            loadEncoded(fd, &h, &dec, (void **) data, realloc, free);
+
+    if (error) {
+        dal_destroyDynarrLO(&tmp);
+        return error;
+    }
+
+    *d = tmp;
+    return DAL_OK;
+}
+
+
+DAL_ERROR dal_loadObjects(DynarrLO *d,
+                          int fd,
+                          DalDecodeFn decode,
+                          void *ctx,
+                          void *(*realloc) (void *, size_t),
+                          void (*free) (void *)) {
+
+    if (!d || !decode || !realloc || !free)
+        return DAL_NULLARG;
+
+    StreamHeader h;
+    DynarrLO tmp;
+    DAL_ERROR error = readHeader(fd, &h);
+
+    if (error || h.encoding != OBJECTS)
+        return DAL_IOFAIL;
+
+    error = dal_createDynarrLO(&tmp, h.length, realloc, free);
+    if (error)
+        return error;
+
+    Decoder dec = {.decode = decode, .ctx = ctx};
+    void **objs = dal_appendUninit(&tmp, h.length);
+
+    error = loadEncoded(fd, &h, &dec, objs, realloc, free);
+
+    if (error) {
+        for (size_t i = 0; i < dec.decoded; ++i)
+            free(objs[i]);
+
+        dal_destroyDynarrLO(&tmp);
+        return error;
+    }
+
+    *d = tmp;
+    return DAL_OK;
+}
+
+
+
+#if DAL_PRIMITIVE_SUPPORT
+
+DAL_ERROR dal_psaveDelta(const DynarrLO *d, int fd) {
+    Writer w;
+    StreamHeader h;
+    size_t chunk = chunkLength(sizeof(size_t));
+    size_t prev = 0;
+
+    begin(&w, &h, d, fd, DELTA, chunk);
+
+    for (size_t i = 0; i < d->length && !w.error; i += chunk) {
+        size_t length = MIN(chunk, d->length - i);
+        unsigned char *buf = room(&w, length * MAX_VARINT);
+        size_t size = 0;
+
+        if (!buf)
+            break;
+
+        for (size_t j = i; j < i + length; ++j) {
+            size += putVarint(buf + size, d->arrayp[j] - prev);
+            prev = d->arrayp[j];
+        }
+
+        putEncoded(&w, length, size);
+    }
+
+    return end(&w);
+}
+
+#endif // DAL_PRIMITIVE_SUPPORT
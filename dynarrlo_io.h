@@ -0,0 +1,154 @@
+//
+// Created by easy on 16.10.26.
+//
+
+#ifndef EASY_DYNARRLO_IO_H
+#define EASY_DYNARRLO_IO_H
+
+#include "dynarrlo.h"
+
+
+#ifndef DAL_IO_CHUNK
+/**
+ * Number of bytes of elements that make up a chunk of a stream. You may define
+ * this macro yourself when compiling the library.
+ */
+#define DAL_IO_CHUNK ((size_t) 1 << 20)
+#endif
+
+
+/*
+ * Binary serialisation of DynarrLO objects to and from file descriptors, e.g.
+ * files, pipes or sockets.
+ *
+ * A stream starts with a header holding the format version, encoding, element
+ * size and length of the array, followed by chunks of elements. Every chunk
+ * has its own header holding the number of its elements, its size in bytes and
+ * a CRC-32C checksum of its bytes, which is computed with the SSE4.2
+ * instruction where available. Chunks are written and read with writev() and
+ * readv() in batches, and raw chunks are read straight into the array, which
+ * is allocated with the final capacity from the start.
+ *
+ * Elements are written either as they are, delta encoded (primitive arrays
+ * only) or through a callback that encodes every object. Streams are only
+ * portable between machines with the same byte order and size of size_t.
+ */
+
+
+/**
+ * Encodes an object for \p dal_saveObjects() .
+ * @param obj Object to encode.
+ * @param buf Buffer receiving the encoded object.
+ * @param size Size of \p buf in bytes.
+ * @param ctx Context passed to \p dal_saveObjects() .
+ * @return Size of the encoded object in bytes. If it exceeds \p size , the
+ * contents of \p buf are ignored and the function is called again with a
+ * buffer that is large enough.
+ */
+typedef size_t (*DalEncodeFn) (const void *obj,
+                               void *buf,
+                               size_t size,
+                               void *ctx);
+
+
+/**
+ * Decodes an object for \p dal_loadObjects() .
+ * @param buf Encoded object.
+ * @param size Size of the encoded object in bytes.
+ * @param obj Receives the decoded object.
+ * @param ctx Context passed to \p dal_loadObjects() .
+ * @return \p DAL_OK or an error code, which aborts loading and is returned by
+ * \p dal_loadObjects() .
+ */
+typedef DAL_ERROR (*DalDecodeFn) (const void *buf,
+                                  size_t size,
+                                  void **obj,
+                                  void *ctx);
+
+
+/**
+ * Writes all elements of a DynarrLO to a file descriptor as they are. Only for
+ * elements that contain no pointers, i.e. primitive arrays and arrays created
+ * by \p dal_createDynarrLOSized() . Use \p dal_saveObjects() for arrays of
+ * pointers.
+ * @param fd File descriptor to write to.
+ * @return \p DAL_OK , \p DAL_ALLOCFAIL if memory couldn't be allocated or
+ * \p DAL_IOFAIL if writing failed.
+ */
+DAL_ERROR dal_save(const DynarrLO *d, int fd);
+
+
+/**
+ * Writes all objects of a DynarrLO created by \p dal_createDynarrLO() to a
+ * file descriptor, encoding each of them with \p encode .
+ * @param fd File descriptor to write to.
+ * @param encode Function encoding an object.
+ * @param ctx Context passed to \p encode .
+ * @return \p DAL_OK , \p DAL_NULLARG if \p encode is NULL, \p DAL_ALLOCFAIL if
+ * memory couldn't be allocated or \p DAL_IOFAIL if writing failed.
+ */
+DAL_ERROR dal_saveObjects(const DynarrLO *d,
+                          int fd,
+                          DalEncodeFn encode,
+                          void *ctx);
+
+
+/**
+ * Tries to create a DynarrLO from a stream written by \p dal_save() or
+ * \p dal_psaveDelta() . The array is allocated once with the length stored in
+ * the stream as its capacity. Does nothing on failure, apart from having
+ * consumed some of the stream.
+ * @param d Pointer to DynarrLO object that shall be initialised.
+ * @param fd File descriptor to read from.
+ * @param realloc realloc function conforming to the C standard.
+ * @param free free function conforming to the C standard.
+ * @return Error code indicating either success \p(DAL_OK), a null argument
+ * error \p(DAL_NULLARG) , failure to allocate the requested amount of memory
+ * \p (DAL_ALLOCFAIL) or failure to read the stream or an invalid or corrupt
+ * stream \p (DAL_IOFAIL) .
+ */
+DAL_ERROR dal_load(DynarrLO *d,
+                   int fd,
+                   void *(*realloc) (void *, size_t),
+                   void (*free) (void *));
+
+
+/**
+ * Tries to create a DynarrLO from a stream written by \p dal_saveObjects() ,
+ * decoding each object with \p decode . On failure, the objects decoded so far
+ * are freed with \p free and nothing else is done.
+ * @param d Pointer to DynarrLO object that shall be initialised.
+ * @param fd File descriptor to read from.
+ * @param decode Function decoding an object.
+ * @param ctx Context passed to \p decode .
+ * @param realloc realloc function conforming to the C standard.
+ * @param free free function conforming to the C standard.
+ * @return Error code indicating either success \p(DAL_OK), a null argument
+ * error \p(DAL_NULLARG) , failure to allocate the requested amount of memory
+ * \p (DAL_ALLOCFAIL) , failure to read the stream or an invalid or corrupt
+ * stream \p (DAL_IOFAIL) or the error returned by \p decode .
+ */
+DAL_ERROR dal_loadObjects(DynarrLO *d,
+                          int fd,
+                          DalDecodeFn decode,
+                          void *ctx,
+                          void *(*realloc) (void *, size_t),
+                          void (*free) (void *));
+
+
+#if DAL_PRIMITIVE_SUPPORT
+
+/**
+ * Writes all values of a primitive DynarrLO to a file descriptor, encoding the
+ * difference of every value to its predecessor as a variable-length integer.
+ * Sorted arrays of values that lie close together shrink to a fraction of
+ * their size. Any other array is written correctly, but may grow by up to a
+ * quarter. Read the stream back with \p dal_load() .
+ * @param fd File descriptor to write to.
+ * @return \p DAL_OK , \p DAL_ALLOCFAIL if memory couldn't be allocated or
+ * \p DAL_IOFAIL if writing failed.
+ */
+DAL_ERROR dal_psaveDelta(const DynarrLO *d, int fd);
+
+#endif // DAL_PRIMITIVE_SUPPORT
+#endif // EASY_DYNARRLO_IO_H
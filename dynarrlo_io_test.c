@@ -0,0 +1,151 @@
+//
+// Created by easy on 16.10.26.
+//
+
+/*
+ * Round trip tests of dynarrlo_io.h. Built with a tiny DAL_IO_CHUNK, so that
+ * a stream consists of more chunks than fit into a single writev() batch.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include "dynarrlo_io.h"
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+
+#if defined(IOV_MAX)
+#define CHUNKS (IOV_MAX + 100)
+#else
+#define CHUNKS 200
+#endif
+
+// Values per chunk of a delta encoded stream.
+#define CHUNK_LENGTH (DAL_IO_CHUNK / sizeof(size_t))
+
+
+static int failures;
+
+
+static void check(int cond, const char *what) {
+    if (!cond) {
+        fprintf(stderr, "FAILED: %s\n", what);
+        ++failures;
+    }
+}
+
+
+// Creates an empty file and rewinds it after writing.
+static int tempFile(void) {
+    FILE *f = tmpfile();
+    return f ? dup(fileno(f)) : -1;
+}
+
+
+static size_t encodeString(const void *obj, void *buf, size_t size,
+                           void *ctx) {
+    (void) ctx;
+    size_t length = strlen(obj);
+
+    if (length <= size)
+        memcpy(buf, obj, length);
+
+    return length;
+}
+
+
+static DAL_ERROR decodeString(const void *buf, size_t size, void **obj,
+                              void *ctx) {
+    (void) ctx;
+    char *s = malloc(size + 1);
+
+    if (!s)
+        return DAL_ALLOCFAIL;
+
+    memcpy(s, buf, size);
+    s[size] = '\0';
+    *obj = s;
+    return DAL_OK;
+}
+
+
+/**
+ * Delta encodes runs of equal deltas followed by varied deltas, so encoded
+ * chunks differ in size, and loads them back.
+ */
+static void testDelta(void) {
+    DynarrLO d;
+    DynarrLO e;
+    size_t x = 0;
+    int fd = tempFile();
+
+    dal_createDynarrLO(&d, 0, realloc, free);
+
+    for (size_t i = 0; i < CHUNKS / 4 * CHUNK_LENGTH; ++i)
+        dal_pappend(&d, ++x);
+
+    for (size_t i = 0; i < CHUNKS * CHUNK_LENGTH; ++i)
+        dal_pappend(&d, x += i * 2654435761u % 100000);
+
+    check(fd >= 0, "temporary file");
+    check(!dal_psaveDelta(&d, fd), "dal_psaveDelta");
+    lseek(fd, 0, SEEK_SET);
+    DAL_ERROR error = dal_load(&e, fd, realloc, free);
+    check(!error, "dal_load of deltas");
+
+    if (!error) {
+        check(e.length == d.length &&
+              !memcmp(e.arrayp, d.arrayp, d.length * sizeof(size_t)),
+              "delta round trip");
+        dal_destroyDynarrLO(&e);
+    }
+
+    close(fd);
+    dal_destroyDynarrLO(&d);
+}
+
+
+static void testObjects(void) {
+    static const char *words[] = {"a", "dynamic", "array", "of", "strings"};
+    DynarrLO d;
+    DynarrLO e;
+    int fd = tempFile();
+    size_t n = CHUNKS * DAL_IO_CHUNK / 4;
+
+    dal_createDynarrLO(&d, n, realloc, free);
+
+    for (size_t i = 0; i < n; ++i)
+        dal_append(&d, (void *) words[i * 7 % 5]);
+
+    check(!dal_saveObjects(&d, fd, encodeString, NULL), "dal_saveObjects");
+    lseek(fd, 0, SEEK_SET);
+    DAL_ERROR error = dal_loadObjects(&e, fd, decodeString, NULL, realloc,
+                                      free);
+    check(!error, "dal_loadObjects");
+
+    if (!error) {
+        int equal = e.length == d.length;
+
+        for (size_t i = 0; i < e.length; ++i) {
+            equal &= !strcmp(e.array[i], d.array[i]);
+            free(e.array[i]);
+        }
+
+        check(equal, "object round trip");
+        dal_destroyDynarrLO(&e);
+    }
+
+    close(fd);
+    dal_destroyDynarrLO(&d);
+}
+
+
+
+int main(void) {
+    testDelta();
+    testObjects();
+    return failures != 0;
+}
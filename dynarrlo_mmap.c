@@ -0,0 +1,541 @@
+//
+// Created by easy on 16.10.26.
+//
+
+#define _GNU_SOURCE
+
+#include "dynarrlo_mmap.h"
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+// Returns the lesser of the two arguments.
+#define MIN(a, b) ((a) <= (b) ? (a) : (b))
+// Returns the greater of the two arguments.
+#define MAX(a, b) ((a) >= (b) ? (a) : (b))
+
+// Distance between the start of a mapping and the data of its block. Keeps the
+// data aligned to cache lines.
+#define MAP_OFFSET 64
+
+#define PROT_RW (PROT_READ | PROT_WRITE)
+
+// "DYNARRLO" in little endian, so files of the other byte order are rejected
+#define FILE_MAGIC 0x4f4c5252414e5944u
+#define FILE_VERSION 1
+
+// "DALBLOCK" in little endian. Tells blocks from files, see isBlock().
+#define BLOCK_TAG 0x4b434f4c424c4144u
+
+
+/**
+ * Bookkeeping in front of the data of every block.
+ */
+typedef struct Block {
+    size_t size;        // Usable bytes
+    size_t mapped;      // Committed bytes of the mapping, 0 if malloc'd
+    size_t reserved;    // Bytes of the whole mapping if it reserves more
+    uint64_t tag;       // BLOCK_TAG
+} Block;
+
+
+/**
+ * Header at the start of a file backing a DynarrLO. The array follows at
+ * MAP_OFFSET. Only describes the array, so it means the same to every process
+ * mapping the file.
+ */
+typedef struct FileHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t wordSize;      // sizeof(size_t) of the writer
+    uint64_t elemSize;
+    uint64_t length;
+    uint64_t capacity;
+    uint64_t padding[2];    // Written as 0, ignored when reading
+    uint64_t tag;           // 0, lies where a block keeps BLOCK_TAG
+} FileHeader;
+
+_Static_assert(sizeof(FileHeader) == MAP_OFFSET,
+               "the tag of a file header must precede the array");
+
+
+/**
+ * What a process needs to manage its mapping of a file. Kept in a private page
+ * mapped right in front of the shared mapping of the file, so that every
+ * process has its own and none of it ends up in the file.
+ */
+typedef struct FileState {
+    size_t mapped;          // Bytes of the shared mapping, the file size
+    int fd;                 // -1 if the file is attached read-only
+} FileState;
+
+
+static Block *blockOf(void *ptr) {
+    return (Block *) ptr - 1;
+}
+
+
+/**
+ * Checks whether ptr is a block of dal_mmapRealloc() rather than the array of
+ * a file. The word in front of either is readable, as it is the tag of the
+ * block or the last field of the file header.
+ */
+static bool isBlock(void *ptr) {
+    return blockOf(ptr)->tag == BLOCK_TAG;
+}
+
+
+static unsigned char *mapBase(void *ptr) {
+    return (unsigned char *) ptr - MAP_OFFSET;
+}
+
+
+static size_t pageSize(void) {
+    static size_t page;
+
+    if (!page)
+        page = (size_t) sysconf(_SC_PAGESIZE);
+
+    return page;
+}
+
+
+static size_t roundPages(size_t n) {
+    size_t page = pageSize();
+    return (n + page - 1) / page * page;
+}
+
+
+static FileHeader *fileOf(void *ptr) {
+    return (FileHeader *) mapBase(ptr);
+}
+
+
+static FileState *stateOf(FileHeader *h) {
+    return (FileState *) h - 1;
+}
+
+
+// Unmaps a file together with the private page in front of it.
+static void unmapFile(FileHeader *h) {
+    munmap((unsigned char *) h - pageSize(), pageSize() + stateOf(h)->mapped);
+}
+
+
+// Size of a file holding capacity elements plus the padding element.
+static size_t fileSize(size_t capacity, size_t elemSize) {
+    return roundPages(MAP_OFFSET + (capacity + 1) * elemSize);
+}
+
+
+/**
+ * Checks that a header describes an array of this platform that fits into a
+ * file of size bytes.
+ */
+static bool validFile(const FileHeader *h, size_t size) {
+    return h->magic == FILE_MAGIC && h->version == FILE_VERSION &&
+           h->wordSize == sizeof(size_t) && h->elemSize &&
+           h->length <= h->capacity && h->tag != BLOCK_TAG &&
+           h->capacity < (SIZE_MAX - MAP_OFFSET) / h->elemSize - 1 &&
+           fileSize(h->capacity, h->elemSize) <= size;
+}
+
+
+/**
+ * Maps a file behind a private page holding its FileState. The file is closed
+ * again on failure.
+ */
+static FileHeader *mapFile(int fd, size_t size, int prot) {
+    size_t page = pageSize();
+    unsigned char *base = mmap(NULL, page + size, PROT_RW,
+                               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (base == MAP_FAILED) {
+        close(fd);
+        return NULL;
+    }
+
+    FileHeader *h = mmap(base + page, size, prot, MAP_SHARED | MAP_FIXED, fd,
+                         0);
+
+    if (h == MAP_FAILED) {
+        munmap(base, page + size);
+        close(fd);
+        return NULL;
+    }
+
+    *stateOf(h) = (FileState) {size, fd};
+    return h;
+}
+
+
+/**
+ * Resizes the mapping of a file from old to size bytes. If it can't grow in
+ * place, it is moved behind a fresh private page, which takes its page tables
+ * along instead of faulting every page in again.
+ * @return Header of the mapping or NULL on failure, in which case the mapping
+ * is untouched.
+ */
+static FileHeader *remapFile(FileHeader *h, size_t old, size_t size) {
+    if (mremap(h, old, size, 0) != MAP_FAILED)
+        return h;
+
+    size_t page = pageSize();
+    unsigned char *base = mmap(NULL, page + size, PROT_RW,
+                               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (base == MAP_FAILED)
+        return NULL;
+
+    FileHeader *moved = mremap(h, old, size, MREMAP_MAYMOVE | MREMAP_FIXED,
+                               base + page);
+
+    if (moved == MAP_FAILED) {
+        munmap(base, page + size);
+        return NULL;
+    }
+
+    *stateOf(moved) = *stateOf(h);
+    munmap((unsigned char *) h - page, page);
+    return moved;
+}
+
+
+// Fills in a DynarrLO for the array of a mapped file.
+static void useFile(DynarrLO *d,
+                    FileHeader *h,
+                    void *(*realloc) (void *, size_t),
+                    void (*free) (void *)) {
+
+    *d = (DynarrLO) {
+        .array = (void **) ((unsigned char *) h + MAP_OFFSET),
+        .length = h->length,
+        .capacity = h->capacity,
+        .elemSize = h->elemSize,
+        .realloc = realloc,
+        .free = free
+    };
+}
+
+
+// Attached files can't grow, but new blocks can be allocated and resized.
+static void *readOnlyRealloc(void *ptr, size_t size) {
+    return !ptr || isBlock(ptr) ? dal_mmapRealloc(ptr, size) : NULL;
+}
+
+
+static void readOnlyFree(void *ptr) {
+    if (ptr && isBlock(ptr))
+        dal_mmapFree(ptr);
+    else if (ptr)
+        unmapFile(fileOf(ptr));
+}
+
+
+static void *mallocBlock(size_t size) {
+    Block *b = malloc(sizeof *b + size);
+    if (!b)
+        return NULL;
+
+    *b = (Block) {size, 0, 0, BLOCK_TAG};
+    return b + 1;
+}
+
+
+/**
+ * Maps a block of size bytes. If reserve exceeds size, address space for
+ * reserve bytes is reserved and only the pages for size bytes are committed.
+ * @return Block or NULL on failure.
+ */
+static void *mapBlock(size_t size, size_t reserve) {
+    size_t mapped = roundPages(MAP_OFFSET + size);
+    size_t total = MAX(mapped, roundPages(MAP_OFFSET + reserve));
+    bool reserving = total > mapped;
+    int prot = reserving ? PROT_NONE : PROT_RW;
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS | (reserving ? MAP_NORESERVE : 0);
+
+    unsigned char *base = mmap(NULL, total, prot, flags, -1, 0);
+    if (base == MAP_FAILED)
+        return NULL;
+
+    if (reserving && mprotect(base, mapped, PROT_RW)) {
+        munmap(base, total);
+        return NULL;
+    }
+
+    void *ptr = base + MAP_OFFSET;
+    *blockOf(ptr) = (Block) {size, mapped, reserving ? total : 0, BLOCK_TAG};
+    return ptr;
+}
+
+
+// Copies the contents of ptr into block and frees ptr. Does nothing if block
+// is NULL.
+static void *moveBlock(void *ptr, void *block, size_t size) {
+    if (!block)
+        return NULL;
+
+    memcpy(block, ptr, MIN(size, blockOf(ptr)->size));
+    dal_mmapFree(ptr);
+    return block;
+}
+
+
+/**
+ * Resizes a block inside its reserved address space by committing or releasing
+ * pages at its end. Moves the block into a fresh mapping if it does not fit.
+ */
+static void *resizeReserved(void *ptr, size_t size) {
+    Block *b = blockOf(ptr);
+    unsigned char *base = mapBase(ptr);
+    size_t mapped = roundPages(MAP_OFFSET + size);
+
+    if (mapped > b->reserved)
+        return moveBlock(ptr, mapBlock(size, 0), size);
+
+    if (mapped > b->mapped) {
+        if (mprotect(base + b->mapped, mapped - b->mapped, PROT_RW))
+            return NULL;
+    } else if (mapped < b->mapped) {
+        madvise(base + mapped, b->mapped - mapped, MADV_DONTNEED);
+        mprotect(base + mapped, b->mapped - mapped, PROT_NONE);
+    }
+
+    b->size = size;
+    b->mapped = mapped;
+    return ptr;
+}
+
+
+
+void *dal_mmapRealloc(void *ptr, size_t size) {
+    bool huge = MAP_OFFSET + size >= DAL_MMAP_THRESHOLD;
+
+    if (!ptr)
+        return huge ? mapBlock(size, 0) : mallocBlock(size);
+
+    Block *b = blockOf(ptr);
+
+    if (!b->mapped) {
+        if (huge)
+            return moveBlock(ptr, mapBlock(size, 0), size);
+
+        b = realloc(b, sizeof *b + size);
+        if (!b)
+            return NULL;
+
+        b->size = size;
+        return b + 1;
+    }
+
+    if (b->reserved)
+        return resizeReserved(ptr, size);
+
+    size_t mapped = roundPages(MAP_OFFSET + size);
+
+    // Pages cut off are handed back, while the mapping is kept for growing
+    if (mapped <= b->mapped) {
+        size_t used = roundPages(MAP_OFFSET + b->size);
+
+        if (mapped < used)
+            madvise(mapBase(ptr) + mapped, used - mapped, MADV_DONTNEED);
+
+        b->size = size;
+        return ptr;
+    }
+    unsigned char *base = mremap(mapBase(ptr), b->mapped, mapped,
+                                 MREMAP_MAYMOVE);
+    if (base == MAP_FAILED)
+        return NULL;
+
+    ptr = base + MAP_OFFSET;
+    blockOf(ptr)->size = size;
+    blockOf(ptr)->mapped = mapped;
+    return ptr;
+}
+
+
+void dal_mmapFree(void *ptr) {
+    if (!ptr)
+        return;
+
+    Block *b = blockOf(ptr);
+
+    if (b->mapped)
+        munmap(mapBase(ptr), b->reserved ? b->reserved : b->mapped);
+    else
+        free(b);
+}
+
+
+void dal_mmapReserve(DynarrLO *d, size_t capacity) {
+    if (d->realloc != dal_mmapRealloc || d->free != dal_mmapFree ||
+        d->alignLog2) {
+        d->error = DAL_NULLARG;
+        return;
+    }
+
+    size_t size = blockOf(d->array)->size;
+    size_t reserve = (MAX(capacity, d->capacity) + 1) * d->elemSize;
+    void *memory = mapBlock(size, reserve);
+
+    if (!memory) {
+        d->error = DAL_ALLOCFAIL;
+        return;
+    }
+
+    d->array = moveBlock(d->array, memory, size);
+    d->error = DAL_OK;
+}
+
+
+DAL_ERROR dal_mmapOpenFile(DynarrLO *d,
+                           const char *path,
+                           size_t capacity,
+                           size_t elemSize) {
+
+    if (!d || !path || !elemSize)
+        return DAL_NULLARG;
+
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    struct stat st;
+
+    if (fd < 0)
+        return DAL_IOFAIL;
+
+    if (fstat(fd, &st)) {
+        close(fd);
+        return DAL_IOFAIL;
+    }
+
+    size_t size = (size_t) st.st_size;
+    bool fresh = !size;
+    FileHeader h;
+
+    if (fresh) {
+        capacity = MAX(capacity, DAL_MIN_CAPACITY);
+        size = fileSize(capacity, elemSize);
+        h = (FileHeader) {FILE_MAGIC, FILE_VERSION, sizeof(size_t), elemSize,
+                          0, capacity, {0}, 0};
+
+        if (ftruncate(fd, (off_t) size) ||
+            pwrite(fd, &h, sizeof h, 0) != sizeof h) {
+            close(fd);
+            return DAL_IOFAIL;
+        }
+    } else if (pread(fd, &h, sizeof h, 0) != sizeof h ||
+               !validFile(&h, size) || h.elemSize != elemSize) {
+        close(fd);
+        return DAL_IOFAIL;
+    }
+
+    FileHeader *mapped = mapFile(fd, size, PROT_RW);
+    if (!mapped)
+        return DAL_ALLOCFAIL;
+
+    useFile(d, mapped, dal_mmapFileRealloc, dal_mmapFileFree);
+
+    // A writer that crashed may have left anything behind the array
+    memset((unsigned char *) d->array + d->capacity * elemSize, 0, elemSize);
+    return DAL_OK;
+}
+
+
+DAL_ERROR dal_mmapAttachFile(DynarrLO *d, const char *path) {
+    if (!d || !path)
+        return DAL_NULLARG;
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    FileHeader h;
+
+    if (fd < 0)
+        return DAL_IOFAIL;
+
+    if (fstat(fd, &st) || pread(fd, &h, sizeof h, 0) != sizeof h ||
+        !validFile(&h, (size_t) st.st_size)) {
+        close(fd);
+        return DAL_IOFAIL;
+    }
+
+    // The mapping stays valid after closing the file
+    FileHeader *mapped = mapFile(fd, (size_t) st.st_size, PROT_READ);
+    if (!mapped)
+        return DAL_ALLOCFAIL;
+
+    close(fd);
+    stateOf(mapped)->fd = -1;
+    useFile(d, mapped, readOnlyRealloc, readOnlyFree);
+    return DAL_OK;
+}
+
+
+void dal_mmapSyncFile(DynarrLO *d) {
+    if (d->free != dal_mmapFileFree || isBlock(d->array)) {
+        d->error = DAL_NULLARG;
+        return;
+    }
+
+    FileHeader *h = fileOf(d->array);
+    h->length = d->length;
+    d->error = msync(h, stateOf(h)->mapped, MS_SYNC) ? DAL_IOFAIL : DAL_OK;
+}
+
+
+void dal_mmapCloseFile(DynarrLO *d) {
+    if (d->free == dal_mmapFileFree && d->array && !isBlock(d->array))
+        fileOf(d->array)->length = d->length;
+
+    dal_destroyDynarrLO(d);
+}
+
+
+void *dal_mmapFileRealloc(void *ptr, size_t size) {
+    if (!ptr || isBlock(ptr))
+        return dal_mmapRealloc(ptr, size);
+
+    FileHeader *h = fileOf(ptr);
+    int fd = stateOf(h)->fd;
+    size_t old = stateOf(h)->mapped;
+    size_t mapped = roundPages(MAP_OFFSET + size);
+
+    if (mapped > old && ftruncate(fd, (off_t) mapped))
+        return NULL;
+
+    FileHeader *base = remapFile(h, old, mapped);
+
+    if (!base) {
+        if (mapped > old)
+            ftruncate(fd, (off_t) old);
+
+        return NULL;
+    }
+
+    if (mapped < old)
+        ftruncate(fd, (off_t) mapped);
+
+    stateOf(base)->mapped = mapped;
+    base->capacity = size / base->elemSize - 1;
+    base->length = MIN(base->length, base->capacity);
+    return (unsigned char *) base + MAP_OFFSET;
+}
+
+
+void dal_mmapFileFree(void *ptr) {
+    if (!ptr || isBlock(ptr)) {
+        dal_mmapFree(ptr);
+        return;
+    }
+
+    FileHeader *h = fileOf(ptr);
+    int fd = stateOf(h)->fd;
+
+    unmapFile(h);
+    close(fd);
+}
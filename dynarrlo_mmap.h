@@ -0,0 +1,178 @@
+//
+// Created by easy on 16.10.26.
+//
+
+#ifndef EASY_DYNARRLO_MMAP_H
+#define EASY_DYNARRLO_MMAP_H
+
+#include "dynarrlo.h"
+
+
+#ifndef DAL_MMAP_THRESHOLD
+/**
+ * Allocations of at least this many bytes are served by anonymous memory
+ * mappings instead of \p malloc() . You may define this macro yourself when
+ * compiling the library.
+ */
+#define DAL_MMAP_THRESHOLD ((size_t) 1 << 20)
+#endif
+
+
+/*
+ * Allocation backend for huge arrays on Linux. Pass dal_mmapRealloc() and
+ * dal_mmapFree() to dal_createDynarrLO() instead of realloc() and free():
+ *
+ *     dal_createDynarrLO(&d, 0, dal_mmapRealloc, dal_mmapFree);
+ *
+ * Small blocks are allocated with malloc(). Once a block reaches
+ * DAL_MMAP_THRESHOLD bytes, it is moved into a page-aligned anonymous mapping.
+ * From then on, growing is done with mremap(), which remaps pages instead of
+ * copying bytes. Pages cut off by shrinking are returned to the operating
+ * system immediately with madvise(), while their address space is kept, so
+ * that growing back into it costs nothing but page faults.
+ *
+ * With dal_mmapReserve() a DynarrLO can reserve a range of address space up
+ * front. Growth within that range only commits more pages and never moves the
+ * array.
+ *
+ * A DynarrLO may also be backed by a file, so that it persists across process
+ * restarts. The file starts with a small header holding the element size,
+ * length and capacity of the array, followed by the elements themselves:
+ *
+ *     dal_mmapOpenFile(&d, "table.dal", 1024, sizeof(size_t));
+ *     dal_pappend(&d, 42);
+ *     dal_mmapCloseFile(&d);
+ *
+ * Opening an existing file maps it and is ready to use right away, without
+ * parsing or copying any element. Growing the array extends the file with
+ * ftruncate() and remaps it with mremap(). The elements must not contain
+ * pointers, as those would be meaningless to the next process. Files are
+ * only portable between machines with the same byte order and size of size_t.
+ */
+
+
+/**
+ * A \p realloc() function conforming to the C standard that switches to memory
+ * mappings for blocks of at least \p DAL_MMAP_THRESHOLD bytes. Blocks must
+ * only be passed to \p dal_mmapRealloc() and \p dal_mmapFree() .
+ * @param ptr Block to resize or NULL to allocate a new block.
+ * @param size Desired size of the block in bytes.
+ * @return Resized block or NULL on failure, in which case \p ptr is untouched.
+ */
+void *dal_mmapRealloc(void *ptr, size_t size);
+
+
+/**
+ * A \p free() function conforming to the C standard for blocks allocated by
+ * \p dal_mmapRealloc() . Unmaps mapped blocks entirely.
+ * @param ptr Block to free, may be NULL.
+ */
+void dal_mmapFree(void *ptr);
+
+
+/**
+ * Moves the array of a DynarrLO into a mapping that reserves address space for
+ * \p capacity elements. Only the pages needed for the current capacity are
+ * committed. Growing the array up to \p capacity afterwards commits more pages
+ * in place and never moves the array. Shrinking it returns the pages cut off
+ * to the operating system with \p madvise() . Growing beyond \p capacity
+ * moves the array into a fresh mapping.\n\n
+ *
+ * The DynarrLO must have been created with \p dal_mmapRealloc() and
+ * \p dal_mmapFree() and without an alignment, as mapped arrays are aligned to
+ * cache lines anyway. Error flag is set to \p DAL_NULLARG if it was not, or to
+ * \p DAL_ALLOCFAIL if the address space couldn't be reserved. The function does
+ * nothing in both cases.
+ * @param capacity Number of elements to reserve address space for.
+ */
+void dal_mmapReserve(DynarrLO *d, size_t capacity);
+
+
+/**
+ * Tries to create a DynarrLO backed by the file at \p path , which is shared
+ * with every other process mapping it. Opens the file for reading and writing
+ * and creates it if it doesn't exist. A new or empty file is initialised with
+ * an empty array. An existing file is mapped as it is and its elements are
+ * available right away. Does nothing on failure.\n\n
+ *
+ * The DynarrLO uses \p dal_mmapFileRealloc() and \p dal_mmapFileFree() . Its
+ * length is only written to the file by \p dal_mmapSyncFile() and
+ * \p dal_mmapCloseFile() , so close it with the latter instead of
+ * \p dal_destroyDynarrLO() . A file must not be opened by more than one
+ * DynarrLO at a time, so don't pass two file-backed arrays to
+ * \p dal_concat() either, as that would swap their files. Memory the library
+ * allocates through the DynarrLO besides its array, such as sort buffers,
+ * clones, search indices and objects, comes from \p dal_mmapRealloc() .
+ * @param d Pointer to DynarrLO object that shall be initialised.
+ * @param path Path of the file.
+ * @param capacity Starting capacity of a new file. Ignored for existing files.
+ * @param elemSize Size of a single element in bytes. Must match the element
+ * size of an existing file.
+ * @return Error code indicating either success \p(DAL_OK), a null argument
+ * error \p(DAL_NULLARG) , failure to map the file \p (DAL_ALLOCFAIL) or
+ * failure to open or extend it or an invalid file \p (DAL_IOFAIL) .
+ */
+DAL_ERROR dal_mmapOpenFile(DynarrLO *d,
+                           const char *path,
+                           size_t capacity,
+                           size_t elemSize);
+
+
+/**
+ * Tries to attach a DynarrLO to the file at \p path read-only. The file is
+ * mapped as it is, so any number of processes may attach to the same file and
+ * share its pages through the page cache. Does nothing on failure.\n\n
+ *
+ * The array must not be modified in any way. Use the read-only 'c' functions
+ * such as \p dal_cpget() to access it and release it with
+ * \p dal_destroyDynarrLO() . The file must not be open for writing while it
+ * is attached. Functions that only allocate new memory through the DynarrLO,
+ * such as \p dal_clone() or \p dal_pcreateSearchIndex() , work as usual and
+ * get it from \p dal_mmapRealloc() .
+ * @param d Pointer to DynarrLO object that shall be initialised.
+ * @param path Path of the file.
+ * @return Error code indicating either success \p(DAL_OK), a null argument
+ * error \p(DAL_NULLARG) , failure to map the file \p (DAL_ALLOCFAIL) or
+ * failure to open it or an invalid file \p (DAL_IOFAIL) .
+ */
+DAL_ERROR dal_mmapAttachFile(DynarrLO *d, const char *path);
+
+
+/**
+ * Writes the length of a DynarrLO created by \p dal_mmapOpenFile() to its file
+ * and waits until all of its modified pages have been written to disk. Error
+ * flag is set to \p DAL_NULLARG if the DynarrLO is not backed by a writable
+ * file or to \p DAL_IOFAIL if the pages couldn't be written.
+ */
+void dal_mmapSyncFile(DynarrLO *d);
+
+
+/**
+ * Writes the length of a DynarrLO created by \p dal_mmapOpenFile() to its file
+ * and destroys the DynarrLO. Modified pages are written to disk by the
+ * operating system afterwards, use \p dal_mmapSyncFile() first to wait for
+ * it.
+ */
+void dal_mmapCloseFile(DynarrLO *d);
+
+
+/**
+ * The \p realloc() function of file-backed arrays. Grows or shrinks the file
+ * with \p ftruncate() and remaps it. New blocks and blocks that aren't files
+ * are passed to \p dal_mmapRealloc() .
+ * @param ptr Array of a file-backed DynarrLO or block, may be NULL.
+ * @param size Desired size of the array in bytes.
+ * @return Resized array or NULL on failure, in which case \p ptr is untouched.
+ */
+void *dal_mmapFileRealloc(void *ptr, size_t size);
+
+
+/**
+ * The \p free() function of file-backed arrays. Unmaps and closes the file.
+ * Other blocks are passed to \p dal_mmapFree() .
+ * @param ptr Array of a file-backed DynarrLO or block, may be NULL.
+ */
+void dal_mmapFileFree(void *ptr);
+
+
+#endif // EASY_DYNARRLO_MMAP_H
@@ -0,0 +1,499 @@
+//
+// Created by easy on 16.10.26.
+//
+
+
+#include "dynarrlo_packed.h"
+#include <limits.h>
+#include <stdbool.h>
+#include <string.h>
+
+#if DAL_PRIMITIVE_SUPPORT
+
+#if defined(__x86_64__) && __SIZEOF_SIZE_T__ == 8 && \
+    (defined(__GNUC__) || defined(__clang__))
+#define PACK_X86 1
+#include <immintrin.h>
+#else
+#define PACK_X86 0
+#endif
+
+
+// Returns the lesser of the two arguments.
+#define MIN(a, b) ((a) <= (b) ? (a) : (b))
+// Returns the greater of the two arguments.
+#define MAX(a, b) ((a) >= (b) ? (a) : (b))
+
+#define BLOCK DAL_PACKED_BLOCK
+#define WORD_BITS (sizeof(size_t) * CHAR_BIT)
+
+// Bits of the second header word of a block holding its bit width.
+#define WIDTH_BITS 8
+#define WIDTH_MASK (((size_t) 1 << WIDTH_BITS) - 1)
+
+
+// Mask of the lowest width bits, branchless for any width up to WORD_BITS.
+static size_t maskOf(size_t width) {
+    return (size_t) -(width != 0) >> ((WORD_BITS - width) & (WORD_BITS - 1));
+}
+
+
+// Number of bits needed to store range.
+static size_t widthOf(size_t range) {
+#if defined(__GNUC__) || defined(__clang__)
+    return range ? WORD_BITS - (size_t) __builtin_clzll(range) : 0;
+#else
+    size_t width = 0;
+
+    for (; range; range >>= 1)
+        ++width;
+
+    return width;
+#endif
+}
+
+
+// Number of words taken up by the bits of a block of the given width.
+static size_t wordsOf(size_t width) {
+    return BLOCK * width / WORD_BITS;
+}
+
+
+// Number of values in packed blocks, i.e. in front of the tail.
+static size_t packedLength(const DalPackedArray *p) {
+    return p->length - p->length % BLOCK;
+}
+
+
+static size_t baseOf(const DalPackedArray *p, size_t block) {
+    return p->blocks.arrayp[2 * block];
+}
+
+
+static size_t metaOf(const DalPackedArray *p, size_t block) {
+    return p->blocks.arrayp[2 * block + 1];
+}
+
+
+static size_t *bitsOf(const DalPackedArray *p, size_t meta) {
+    return p->words.arrayp + (meta >> WIDTH_BITS);
+}
+
+
+/**
+ * Extracts value j of a block whose bits start at src. A value that starts
+ * near the end of a word continues in the next one.
+ */
+static size_t extract(const size_t *src, size_t width, size_t j) {
+    size_t bit = j * width;
+    size_t shift = bit % WORD_BITS;
+    const size_t *word = src + bit / WORD_BITS;
+    size_t val = word[0] >> shift;
+
+    if (shift + width > WORD_BITS)
+        val |= word[1] << (WORD_BITS - shift);
+
+    return val & maskOf(width);
+}
+
+
+// Overwrites value j of a block whose bits start at dst.
+static void deposit(size_t *dst, size_t width, size_t j, size_t val) {
+    size_t bit = j * width;
+    size_t shift = bit % WORD_BITS;
+    size_t mask = maskOf(width);
+    size_t *word = dst + bit / WORD_BITS;
+
+    word[0] = (word[0] & ~(mask << shift)) | val << shift;
+
+    if (shift + width > WORD_BITS) {
+        size_t rest = WORD_BITS - shift;
+        word[1] = (word[1] & ~(mask >> rest)) | val >> rest;
+    }
+}
+
+
+static void unpackScalar(const size_t *src,
+                         size_t width,
+                         size_t base,
+                         size_t first,
+                         size_t n,
+                         size_t *out) {
+
+    for (size_t j = 0; j < n; ++j)
+        out[j] = base + extract(src, width, first + j);
+}
+
+
+// Unpacks values [first, first + n) of a block.
+static void (*unpack) (const size_t *, size_t, size_t, size_t, size_t,
+                       size_t *) = unpackScalar;
+
+
+#if PACK_X86
+
+#define AVX2 __attribute__((target("avx2")))
+
+
+/**
+ * Unpacks 4 values per vector. Every lane gathers the word its value starts in
+ * and the one after it and shifts both into place. Shifting by 64 bits yields
+ * 0, so values that don't continue in the next word need no special case.
+ */
+AVX2 static void unpackAVX2(const size_t *src,
+                            size_t width,
+                            size_t base,
+                            size_t first,
+                            size_t n,
+                            size_t *out) {
+
+    const long long *words = (const long long *) src;
+    __m256i w = _mm256_set1_epi64x((long long) width);
+    __m256i j = _mm256_add_epi64(_mm256_set1_epi64x((long long) first),
+                                 _mm256_setr_epi64x(0, 1, 2, 3));
+    __m256i four = _mm256_set1_epi64x(4);
+    __m256i bits = _mm256_set1_epi64x(WORD_BITS);
+    __m256i low = _mm256_set1_epi64x(WORD_BITS - 1);
+    __m256i mask = _mm256_set1_epi64x((long long) maskOf(width));
+    __m256i b = _mm256_set1_epi64x((long long) base);
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        __m256i bit = _mm256_mul_epu32(j, w);
+        __m256i index = _mm256_srli_epi64(bit, 6);
+        __m256i shift = _mm256_and_si256(bit, low);
+        __m256i lo = _mm256_i64gather_epi64(words, index, 8);
+        __m256i hi = _mm256_i64gather_epi64(words + 1, index, 8);
+        __m256i val = _mm256_or_si256(
+                _mm256_srlv_epi64(lo, shift),
+                _mm256_sllv_epi64(hi, _mm256_sub_epi64(bits, shift)));
+
+        val = _mm256_add_epi64(_mm256_and_si256(val, mask), b);
+        _mm256_storeu_si256((__m256i *) (out + i), val);
+        j = _mm256_add_epi64(j, four);
+    }
+
+    unpackScalar(src, width, base, first + i, n - i, out + i);
+}
+
+
+// Picks the AVX2 unpacking once when the program is loaded.
+__attribute__((constructor)) static void selectUnpack(void) {
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
+        unpack = unpackAVX2;
+}
+
+#endif // PACK_X86
+
+
+// Unpacks values [first, first + n) of a packed block.
+static void decodeBlock(const DalPackedArray *p,
+                        size_t block,
+                        size_t first,
+                        size_t n,
+                        size_t *out) {
+
+    size_t meta = metaOf(p, block);
+    size_t width = meta & WIDTH_MASK;
+
+    // A block of equal values has no bits that could be read
+    if (!width) {
+        for (size_t j = 0; j < n; ++j)
+            out[j] = baseOf(p, block);
+
+        return;
+    }
+
+    unpack(bitsOf(p, meta), width, baseOf(p, block), first, n, out);
+}
+
+
+/**
+ * Packs the values of a block, which is either an existing block or a new one
+ * behind all others, as tightly as possible. The bits of the last block in
+ * memory simply grow or shrink. Any other block keeps its place if it doesn't
+ * grow and is moved behind all other blocks otherwise.
+ * @return False iff memory allocation failed, in which case nothing is done.
+ */
+static bool storeBlock(DalPackedArray *p, size_t block, const size_t *vals) {
+    size_t lo = vals[0];
+    size_t hi = vals[0];
+
+    for (size_t j = 1; j < BLOCK; ++j) {
+        lo = MIN(lo, vals[j]);
+        hi = MAX(hi, vals[j]);
+    }
+
+    size_t width = widthOf(hi - lo);
+    bool fresh = 2 * block == p->blocks.length;
+    size_t meta = fresh ? p->words.length << WIDTH_BITS : metaOf(p, block);
+    size_t offset = meta >> WIDTH_BITS;
+    size_t old = wordsOf(meta & WIDTH_MASK);
+    size_t unused = p->unused;
+    bool last = offset + old == p->words.length;
+
+    if (!last && wordsOf(width) > old) {
+        unused += old;
+        offset = p->words.length;
+        last = true;
+    } else if (!last) {
+        unused += old - wordsOf(width);
+    }
+
+    size_t length = last ? offset + wordsOf(width) : p->words.length;
+
+    dal_reserve(&p->words, length);
+    dal_reserve(&p->blocks, p->blocks.length + 2 * fresh);
+
+    if (p->words.error || p->blocks.error)
+        return false;
+
+    dal_setLength(&p->words, length);
+    dal_setLength(&p->blocks, p->blocks.length + 2 * fresh);
+
+    size_t *dst = p->words.arrayp + offset;
+    memset(dst, 0, wordsOf(width) * sizeof *dst);
+
+    for (size_t j = 0; j < BLOCK && width; ++j)
+        deposit(dst, width, j, vals[j] - lo);
+
+    p->blocks.arrayp[2 * block] = lo;
+    p->blocks.arrayp[2 * block + 1] = offset << WIDTH_BITS | width;
+    p->unused = unused;
+    return true;
+}
+
+
+
+DAL_ERROR dal_createPackedArray(DalPackedArray *p,
+                                void *(*realloc) (void *, size_t),
+                                void (*free) (void *)) {
+
+    if (!p)
+        return DAL_NULLARG;
+
+    DalPackedArray tmp = {0};
+    DAL_ERROR error = dal_createDynarrLO(&tmp.words, 0, realloc, free);
+
+    if (error)
+        return error;
+
+    error = dal_createDynarrLO(&tmp.blocks, 0, realloc, free);
+
+    if (error) {
+        dal_destroyDynarrLO(&tmp.words);
+        return error;
+    }
+
+    *p = tmp;
+    return DAL_OK;
+}
+
+
+DAL_ERROR dal_ppack(DalPackedArray *p, const DynarrLO *src) {
+    if (!p || !src)
+        return DAL_NULLARG;
+
+    DalPackedArray tmp;
+    DAL_ERROR error = dal_createPackedArray(&tmp, src->realloc, src->free);
+
+    if (error)
+        return error;
+
+    size_t full = src->length / BLOCK;
+    dal_reserve(&tmp.blocks, 2 * full);
+
+    for (size_t b = 0; b < full && !tmp.blocks.error; ++b)
+        if (!storeBlock(&tmp, b, src->arrayp + b * BLOCK))
+            tmp.blocks.error = DAL_ALLOCFAIL;
+
+    if (tmp.blocks.error) {
+        dal_destroyPackedArray(&tmp);
+        return DAL_ALLOCFAIL;
+    }
+
+    memcpy(tmp.tail, src->arrayp + full * BLOCK,
+           src->length % BLOCK * sizeof *tmp.tail);
+    tmp.length = src->length;
+    *p = tmp;
+    return DAL_OK;
+}
+
+
+DAL_ERROR dal_punpack(DynarrLO *dst, const DalPackedArray *p) {
+    if (!dst || !p)
+        return DAL_NULLARG;
+
+    DynarrLO tmp;
+    DAL_ERROR error = dal_createDynarrLO(&tmp, p->length, p->words.realloc,
+                                         p->words.free);
+    if (error)
+        return error;
+
+    size_t *out = dal_appendUninit(&tmp, p->length);
+    size_t packed = packedLength(p);
+
+    for (size_t i = 0; i < packed; i += BLOCK)
+        decodeBlock(p, i / BLOCK, 0, BLOCK, out + i);
+
+    memcpy(out + packed, p->tail, (p->length - packed) * sizeof *out);
+    *dst = tmp;
+    return DAL_OK;
+}
+
+
+void dal_destroyPackedArray(DalPackedArray *p) {
+    dal_destroyDynarrLO(&p->blocks);
+    dal_destroyDynarrLO(&p->words);
+    *p = (DalPackedArray) {0};
+}
+
+
+size_t dal_ppackedBytes(const DalPackedArray *p) {
+    return (p->blocks.capacity + p->words.capacity + 2) * sizeof(size_t);
+}
+
+
+void dal_ppackedShrinkToFit(DalPackedArray *p) {
+    DynarrLO words;
+    size_t blocks = p->blocks.length / 2;
+    size_t used = p->words.length - p->unused;
+
+    p->error = dal_createDynarrLO(&words, used, p->words.realloc,
+                                  p->words.free);
+    if (p->error)
+        return;
+
+    // Copy the bits of all blocks in block order
+    for (size_t b = 0; b < blocks; ++b) {
+        size_t meta = metaOf(p, b);
+        size_t n = wordsOf(meta & WIDTH_MASK);
+
+        p->blocks.arrayp[2 * b + 1] = words.length << WIDTH_BITS |
+                                      (meta & WIDTH_MASK);
+        memcpy(dal_appendUninit(&words, n), bitsOf(p, meta),
+               n * sizeof(size_t));
+    }
+
+    dal_destroyDynarrLO(&p->words);
+    p->words = words;
+    p->unused = 0;
+    dal_shrinkToFit(&p->blocks);
+}
+
+
+void dal_ppackedAppend(DalPackedArray *p, size_t val) {
+    size_t t = p->length % BLOCK;
+    p->tail[t] = val;
+
+    if (t == BLOCK - 1 && !storeBlock(p, p->length / BLOCK, p->tail)) {
+        p->error = DAL_ALLOCFAIL;
+        return;
+    }
+
+    ++p->length;
+    p->error = DAL_OK;
+}
+
+
+size_t dal_ppackedGet(DalPackedArray *p, size_t index) {
+    return dal_cppackedGet(p, index, &p->error);
+}
+
+
+size_t dal_cppackedGet(const DalPackedArray *p,
+                       size_t index,
+                       DAL_ERROR *error) {
+
+    if (error)
+        *error = index >= p->length;
+
+    if (index >= packedLength(p))
+        return index < p->length ? p->tail[index % BLOCK] : 0;
+
+    size_t block = index / BLOCK;
+    size_t meta = metaOf(p, block);
+    return baseOf(p, block) +
+           extract(bitsOf(p, meta), meta & WIDTH_MASK, index % BLOCK);
+}
+
+
+void dal_ppackedWrite(DalPackedArray *p, size_t index, size_t val) {
+    if ((p->error = index >= p->length))
+        return;
+
+    if (index >= packedLength(p)) {
+        p->tail[index % BLOCK] = val;
+        return;
+    }
+
+    size_t block = index / BLOCK;
+    size_t base = baseOf(p, block);
+    size_t meta = metaOf(p, block);
+    size_t width = meta & WIDTH_MASK;
+
+    if (val >= base && val - base <= maskOf(width)) {
+        deposit(bitsOf(p, meta), width, index % BLOCK, val - base);
+        return;
+    }
+
+    size_t vals[BLOCK];
+    decodeBlock(p, block, 0, BLOCK, vals);
+    vals[index % BLOCK] = val;
+
+    if (!storeBlock(p, block, vals))
+        p->error = DAL_ALLOCFAIL;
+}
+
+
+size_t dal_ppackedPop(DalPackedArray *p) {
+    if ((p->error = !p->length))
+        return 0;
+
+    // Unpack the last block into the tail, giving its bits back
+    if (p->length == packedLength(p)) {
+        size_t block = p->length / BLOCK - 1;
+        size_t meta = metaOf(p, block);
+        size_t offset = meta >> WIDTH_BITS;
+        size_t n = wordsOf(meta & WIDTH_MASK);
+
+        decodeBlock(p, block, 0, BLOCK, p->tail);
+
+        if (offset + n == p->words.length)
+            dal_setLength(&p->words, offset);
+        else
+            p->unused += n;
+
+        dal_removeLastMany(&p->blocks, 2);
+    }
+
+    --p->length;
+    return p->tail[p->length % BLOCK];
+}
+
+
+size_t dal_ppackedDecode(DalPackedArray *p,
+                         size_t begin,
+                         size_t end,
+                         size_t *out) {
+
+    p->error = (begin > end) | (end > p->length);
+    end = MIN(end, p->length);
+    begin = MIN(begin, end);
+
+    size_t packed = MIN(end, packedLength(p));
+    size_t i = begin;
+
+    while (i < packed) {
+        size_t n = MIN(BLOCK - i % BLOCK, packed - i);
+        decodeBlock(p, i / BLOCK, i % BLOCK, n, out + (i - begin));
+        i += n;
+    }
+
+    memcpy(out + (i - begin), p->tail + i % BLOCK, (end - i) * sizeof *out);
+    return end - begin;
+}
+
+#endif // DAL_PRIMITIVE_SUPPORT
@@ -0,0 +1,214 @@
+//
+// Created by easy on 16.10.26.
+//
+
+#ifndef EASY_DYNARRLO_PACKED_H
+#define EASY_DYNARRLO_PACKED_H
+
+#include "dynarrlo.h"
+
+#if DAL_PRIMITIVE_SUPPORT
+
+/**
+ * Number of values that share a frame of reference and a bit width.
+ */
+#define DAL_PACKED_BLOCK 128
+
+
+/**
+ * A compressed array of \p size_t values. Values are stored in blocks of
+ * \p DAL_PACKED_BLOCK values. Every block stores the difference of each value
+ * to the smallest value of the block (frame of reference), packed with as many
+ * bits as the largest difference needs. A block of small values, IDs or counts
+ * or a block of a sorted array of values close together thus takes only a few
+ * bits per value instead of 64.\n\n
+ *
+ * Every block has a header holding its smallest value, its bit width and the
+ * position of its bits, so \p dal_ppackedGet() takes constant time. The last,
+ * incomplete block is kept uncompressed and is packed once it is full.
+ * \p dal_ppackedDecode() unpacks ranges of values, using AVX2 where
+ * available.\n\n
+ *
+ * Writing a value that doesn't fit into the bit width of its block repacks the
+ * block. If the block grows, it is moved behind all other blocks and its old
+ * bits are left unused until \p dal_ppackedShrinkToFit() is called.\n\n
+ *
+ * Do not modify or access the fields of this struct manually.
+ */
+typedef struct DalPackedArray {
+    /**
+     * Two words per packed block: its smallest value and the position of its
+     * bits in \p words shifted left by 8 bits, combined with its bit width.
+     */
+    DynarrLO blocks;
+
+    /**
+     * Packed bits of all blocks. Also holds the \p realloc() and \p free()
+     * functions.
+     */
+    DynarrLO words;
+
+    /**
+     * Current amount of values in this packed array.
+     */
+    size_t length;
+
+    /**
+     * Number of words in \p words no longer used by any block.
+     */
+    size_t unused;
+
+    /**
+     * Error flag.
+     */
+    DAL_ERROR error;
+
+    /**
+     * Values of the last, incomplete block.
+     */
+    size_t tail[DAL_PACKED_BLOCK];
+} DalPackedArray;
+
+
+/**
+ * Simple accessor function to retrieve the length of a packed array.\n\n
+ * This function is declared \p static \p inline .
+ * @return Current amount of values in this packed array.
+ */
+static inline size_t dal_ppackedLen(const DalPackedArray *p) {
+    return p->length;
+}
+
+
+/**
+ * Simple accessor function to retrieve the value of the error flag of a packed
+ * array.\n\n
+ * This function is declared \p static \p inline .
+ * @return Error flag value.
+ */
+static inline DAL_ERROR dal_ppackedErr(const DalPackedArray *p) {
+    return p->error;
+}
+
+
+/**
+ * Tries to create an empty packed array. Does nothing on failure.
+ * @param p Pointer to packed array object that shall be initialised.
+ * @param realloc realloc function conforming to the C standard.
+ * @param free free function conforming to the C standard.
+ * @return Error code indicating either success \p(DAL_OK), a null argument
+ * error \p(DAL_NULLARG) or failure to allocate memory \p (DAL_ALLOCFAIL) .
+ */
+DAL_ERROR dal_createPackedArray(DalPackedArray *p,
+                                void *(*realloc) (void *, size_t),
+                                void (*free) (void *));
+
+
+/**
+ * Tries to create a packed array holding all values of a primitive DynarrLO,
+ * using its \p realloc() and \p free() functions. Does nothing on failure.
+ * @param p Pointer to packed array object that shall be initialised.
+ * @param src DynarrLO to compress, which is not modified.
+ * @return Error code indicating either success \p(DAL_OK), a null argument
+ * error \p(DAL_NULLARG) or failure to allocate memory \p (DAL_ALLOCFAIL) .
+ */
+DAL_ERROR dal_ppack(DalPackedArray *p, const DynarrLO *src);
+
+
+/**
+ * Tries to create a primitive DynarrLO holding all values of a packed array,
+ * using its \p realloc() and \p free() functions. Does nothing on failure.
+ * @param dst Pointer to DynarrLO object that shall be initialised.
+ * @param p Packed array to decompress, which is not modified.
+ * @return Error code indicating either success \p(DAL_OK), a null argument
+ * error \p(DAL_NULLARG) or failure to allocate memory \p (DAL_ALLOCFAIL) .
+ */
+DAL_ERROR dal_punpack(DynarrLO *dst, const DalPackedArray *p);
+
+
+/**
+ * Frees all memory of this packed array and sets all struct fields to 0.
+ */
+void dal_destroyPackedArray(DalPackedArray *p);
+
+
+/**
+ * Gets the number of bytes allocated for the blocks of this packed array,
+ * not counting the struct itself.
+ * @return Allocated bytes.
+ */
+size_t dal_ppackedBytes(const DalPackedArray *p);
+
+
+/**
+ * Moves all blocks next to each other, so that no bits are left unused, and
+ * frees all memory that isn't needed. Error flag is set to \p DAL_ALLOCFAIL if
+ * memory couldn't be allocated, in which case the array is not modified.
+ */
+void dal_ppackedShrinkToFit(DalPackedArray *p);
+
+
+/**
+ * Appends a value to the back of the array, packing the last block once it is
+ * full. Error flag is set to \p DAL_ALLOCFAIL if memory couldn't be allocated,
+ * in which case the value is not appended.
+ * @param val Value to append.
+ */
+void dal_ppackedAppend(DalPackedArray *p, size_t val);
+
+
+/**
+ * Gets the value at \p index in constant time. Error flag is set to
+ * \p DAL_OUTOFRANGE if \p index >= length.
+ * @param index Index to access.
+ * @return Value at \p index or 0 if \p index >= length.
+ */
+size_t dal_ppackedGet(DalPackedArray *p, size_t index);
+
+
+/**
+ * Read-only version of \p dal_ppackedGet() , see \p dal_cget() .
+ * @param index Index to access.
+ * @param error Receives the error code. May be NULL.
+ * @return Value at \p index or 0 if \p index >= length.
+ */
+size_t dal_cppackedGet(const DalPackedArray *p,
+                       size_t index,
+                       DAL_ERROR *error);
+
+
+/**
+ * Overwrites the value at \p index . Repacks its block if the value doesn't
+ * fit. Does nothing if \p index >= length, in which case error flag is set to
+ * \p DAL_OUTOFRANGE , or if memory couldn't be allocated, in which case it is
+ * set to \p DAL_ALLOCFAIL .
+ * @param index Index to overwrite.
+ * @param val Value that shall be written at the \p index.
+ */
+void dal_ppackedWrite(DalPackedArray *p, size_t index, size_t val);
+
+
+/**
+ * Removes the hindmost value and returns it. Error flag is set to
+ * \p DAL_OUTOFRANGE if array is empty.
+ * @return Hindmost value or 0 if array is empty.
+ */
+size_t dal_ppackedPop(DalPackedArray *p);
+
+
+/**
+ * Unpacks the values in [ \p begin , \p end ) into a buffer, one block at a
+ * time. Error flag is set to \p DAL_OUTOFRANGE if the range exceeds the array,
+ * in which case it is cut off at length.
+ * @param begin Index of the first value (inclusive).
+ * @param end Index behind the last value (exclusive).
+ * @param out Buffer receiving the values.
+ * @return Number of values written to \p out .
+ */
+size_t dal_ppackedDecode(DalPackedArray *p,
+                         size_t begin,
+                         size_t end,
+                         size_t *out);
+
+#endif // DAL_PRIMITIVE_SUPPORT
+#endif // EASY_DYNARRLO_PACKED_H
@@ -0,0 +1,435 @@
+//
+// Created by easy on 16.10.26.
+//
+
+#define _DEFAULT_SOURCE
+
+#include "dynarrlo_parallel.h"
+#include "dynarrlo_sort.h"
+#include <limits.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <unistd.h>
+
+
+// Returns the lesser of the two arguments.
+#define MIN(a, b) ((a) <= (b) ? (a) : (b))
+// Returns the greater of the two arguments.
+#define MAX(a, b) ((a) >= (b) ? (a) : (b))
+
+// Bits of a value that a radix pass distributes by, see dynarrlo_sort.c.
+#define RADIX_BITS 11
+#define RADIX (1 << RADIX_BITS)
+#define PASSES ((sizeof(size_t) * CHAR_BIT + RADIX_BITS - 1) / RADIX_BITS)
+
+
+/**
+ * Tasks [next, end) of a thread. The owner and thieves alike claim tasks by
+ * incrementing next. Padded to a cache line so the threads don't contend for
+ * each other's queues.
+ */
+struct DalQueue {
+    atomic_size_t next;
+    size_t end;
+    DalPool *pool;
+    unsigned char padding[64 - sizeof(atomic_size_t) - sizeof(size_t) -
+                          sizeof(DalPool *)];
+};
+
+
+/**
+ * Runs tasks of the current job until there are none left, starting with the
+ * queue of thread self and then stealing from the queues of the others.
+ */
+static void work(DalPool *p, size_t self) {
+    for (size_t v = 0; v < p->size; ++v) {
+        DalQueue *q = p->queues + (self + v) % p->size;
+
+        for (size_t i; (i = atomic_fetch_add(&q->next, 1)) < q->end;)
+            p->task(i, p->ctx);
+    }
+}
+
+
+// Runs the jobs of a pool. Its argument is the queue of the thread.
+static void *workerMain(void *arg) {
+    DalPool *p = ((DalQueue *) arg)->pool;
+    size_t self = (size_t) ((DalQueue *) arg - p->queues);
+    size_t seen = 0;
+
+    for (;;) {
+        pthread_mutex_lock(&p->lock);
+
+        while (!p->stop && p->generation == seen)
+            pthread_cond_wait(&p->wake, &p->lock);
+
+        if (p->stop) {
+            pthread_mutex_unlock(&p->lock);
+            return NULL;
+        }
+
+        seen = p->generation;
+        pthread_mutex_unlock(&p->lock);
+
+        work(p, self);
+
+        pthread_mutex_lock(&p->lock);
+
+        if (!--p->busy)
+            pthread_cond_signal(&p->done);
+
+        pthread_mutex_unlock(&p->lock);
+    }
+}
+
+
+/**
+ * Runs tasks [0, tasks) on all threads of the pool and returns once all of
+ * them are done. Every thread starts out with an equal share of the tasks.
+ */
+static void run(DalPool *p,
+                size_t tasks,
+                void (*task) (size_t, void *),
+                void *ctx) {
+
+    if (tasks <= 1 || p->size == 1) {
+        for (size_t i = 0; i < tasks; ++i)
+            task(i, ctx);
+
+        return;
+    }
+
+    for (size_t t = 0; t < p->size; ++t) {
+        atomic_store(&p->queues[t].next, tasks * t / p->size);
+        p->queues[t].end = tasks * (t + 1) / p->size;
+    }
+
+    pthread_mutex_lock(&p->lock);
+    p->task = task;
+    p->ctx = ctx;
+    p->busy = p->size - 1;
+    ++p->generation;
+    pthread_cond_broadcast(&p->wake);
+    pthread_mutex_unlock(&p->lock);
+
+    work(p, 0);
+
+    pthread_mutex_lock(&p->lock);
+
+    while (p->busy)
+        pthread_cond_wait(&p->done, &p->lock);
+
+    pthread_mutex_unlock(&p->lock);
+}
+
+
+/**
+ * Cuts a range off at the length of the array.
+ * @return Error code for the range.
+ */
+static DAL_ERROR clampRange(const DynarrLO *d, size_t *begin, size_t *end) {
+    DAL_ERROR error = (*begin > *end) | (*end > d->length);
+    *end = MIN(*end, d->length);
+    *begin = MIN(*begin, *end);
+    return error;
+}
+
+
+static size_t blocks(size_t begin, size_t end) {
+    return (end - begin + DAL_PARALLEL_GRAIN - 1) / DAL_PARALLEL_GRAIN;
+}
+
+
+/**
+ * A range of an array split into blocks of DAL_PARALLEL_GRAIN elements.
+ */
+typedef struct Range {
+    DynarrLO *d;
+    size_t begin;
+    size_t end;
+    void *ctx;
+
+    // Exactly one of them is set
+    DalSpanFn map;
+    DalReduceFn reduce;
+    size_t *partials;
+} Range;
+
+
+// Gets the span of a block. Writes the index of its first element to first.
+static DalSpan blockSpan(const Range *r, size_t block, size_t *first) {
+    *first = r->begin + block * DAL_PARALLEL_GRAIN;
+    size_t length = MIN(r->end - *first, DAL_PARALLEL_GRAIN);
+    unsigned char *data = (unsigned char *) r->d->array;
+    return (DalSpan) {data + *first * r->d->elemSize, length};
+}
+
+
+static void blockTask(size_t block, void *ctx) {
+    Range *r = ctx;
+    size_t first;
+    DalSpan span = blockSpan(r, block, &first);
+
+    if (r->map)
+        r->map(span, first, r->ctx);
+    else
+        r->partials[block] = r->reduce(span, first, r->ctx);
+}
+
+
+
+DAL_ERROR dal_createPool(DalPool *p,
+                         size_t threads,
+                         void *(*realloc) (void *, size_t),
+                         void (*free) (void *)) {
+
+    if (!p || !realloc || !free)
+        return DAL_NULLARG;
+
+    if (!threads) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (size_t) cpus : 1;
+    }
+
+    *p = (DalPool) {.size = threads, .realloc = realloc, .free = free};
+    p->queues = realloc(NULL, threads * sizeof *p->queues);
+    p->threads = realloc(NULL, MAX(threads - 1, 1) * sizeof *p->threads);
+
+    if (!p->queues || !p->threads || pthread_mutex_init(&p->lock, NULL)) {
+        free(p->queues);
+        free(p->threads);
+        *p = (DalPool) {0};
+        return DAL_ALLOCFAIL;
+    }
+
+    pthread_cond_init(&p->wake, NULL);
+    pthread_cond_init(&p->done, NULL);
+
+    for (size_t t = 0; t < threads; ++t) {
+        atomic_init(&p->queues[t].next, 0);
+        p->queues[t].end = 0;
+        p->queues[t].pool = p;
+    }
+
+    // Worker t runs queue t + 1, queue 0 belongs to the calling thread
+    size_t started = 0;
+
+    for (; started < threads - 1; ++started)
+        if (pthread_create(p->threads + started, NULL, workerMain,
+                           p->queues + started + 1))
+            break;
+
+    if (started < threads - 1) {
+        pthread_mutex_lock(&p->lock);
+        p->size = started + 1;
+        pthread_mutex_unlock(&p->lock);
+        dal_destroyPool(p);
+        return DAL_ALLOCFAIL;
+    }
+
+    return DAL_OK;
+}
+
+
+void dal_destroyPool(DalPool *p) {
+    pthread_mutex_lock(&p->lock);
+    p->stop = true;
+    pthread_cond_broadcast(&p->wake);
+    pthread_mutex_unlock(&p->lock);
+
+    for (size_t t = 0; t + 1 < p->size; ++t)
+        pthread_join(p->threads[t], NULL);
+
+    pthread_cond_destroy(&p->wake);
+    pthread_cond_destroy(&p->done);
+    pthread_mutex_destroy(&p->lock);
+    p->free(p->threads);
+    p->free(p->queues);
+    *p = (DalPool) {0};
+}
+
+
+void dal_parallelFor(DalPool *p,
+                     DynarrLO *d,
+                     size_t begin,
+                     size_t end,
+                     DalSpanFn fn,
+                     void *ctx) {
+
+    d->error = clampRange(d, &begin, &end);
+    Range r = {d, begin, end, ctx, fn, NULL, NULL};
+    run(p, blocks(begin, end), blockTask, &r);
+}
+
+
+size_t dal_parallelReduce(DalPool *p,
+                          DynarrLO *d,
+                          size_t begin,
+                          size_t end,
+                          size_t identity,
+                          DalReduceFn fn,
+                          DalCombineFn combine,
+                          void *ctx) {
+
+    d->error = clampRange(d, &begin, &end);
+    size_t n = blocks(begin, end);
+    size_t result = identity;
+
+    if (!n)
+        return result;
+
+    size_t *partials = p->realloc(NULL, n * sizeof *partials);
+    if (!partials) {
+        d->error = DAL_ALLOCFAIL;
+        return result;
+    }
+
+    Range r = {d, begin, end, ctx, NULL, fn, partials};
+    run(p, n, blockTask, &r);
+
+    for (size_t i = 0; i < n; ++i)
+        result = combine(result, partials[i], ctx);
+
+    p->free(partials);
+    return result;
+}
+
+
+
+#if DAL_PRIMITIVE_SUPPORT
+
+typedef struct Transform {
+    size_t (*fn) (size_t, void *);
+    void *ctx;
+} Transform;
+
+
+static void transformSpan(DalSpan span, size_t first, void *ctx) {
+    Transform *t = ctx;
+    size_t *vals = span.data;
+    (void) first;
+
+    for (size_t i = 0; i < span.length; ++i)
+        vals[i] = t->fn(vals[i], t->ctx);
+}
+
+
+void dal_pparallelTransform(DalPool *p,
+                            DynarrLO *d,
+                            size_t begin,
+                            size_t end,
+                            size_t (*fn) (size_t val, void *ctx),
+                            void *ctx) {
+
+    Transform t = {fn, ctx};
+    dal_parallelFor(p, d, begin, end, transformSpan, &t);
+}
+
+
+
+/**
+ * State of a parallel radix sort. The array is split into one part per task.
+ * Every part has its own histogram per pass, which after counting is turned
+ * into the offsets its values are distributed to.
+ */
+typedef struct RadixSort {
+    size_t *src;
+    size_t *dst;
+    size_t n;
+    size_t parts;
+    size_t pass;
+    size_t *counts;     // parts * RADIX counters
+} RadixSort;
+
+
+static size_t digit(size_t val, size_t pass) {
+    return (val >> pass * RADIX_BITS) & (RADIX - 1);
+}
+
+
+static void countPart(size_t part, void *ctx) {
+    RadixSort *s = ctx;
+    size_t *counts = s->counts + part * RADIX;
+    size_t end = s->n * (part + 1) / s->parts;
+
+    memset(counts, 0, RADIX * sizeof *counts);
+
+    for (size_t i = s->n * part / s->parts; i < end; ++i)
+        ++counts[digit(s->src[i], s->pass)];
+}
+
+
+static void distributePart(size_t part, void *ctx) {
+    RadixSort *s = ctx;
+    size_t *offsets = s->counts + part * RADIX;
+    size_t end = s->n * (part + 1) / s->parts;
+
+    for (size_t i = s->n * part / s->parts; i < end; ++i)
+        s->dst[offsets[digit(s->src[i], s->pass)]++] = s->src[i];
+}
+
+
+/**
+ * Turns the histograms of all parts into offsets. Values of lower digits come
+ * first, values of the same digit are ordered by part.
+ * @return False iff all values share the same digit.
+ */
+static bool prefixCounts(RadixSort *s) {
+    size_t sum = 0;
+
+    for (size_t b = 0; b < RADIX; ++b) {
+        size_t bucket = sum;
+
+        for (size_t part = 0; part < s->parts; ++part) {
+            size_t *count = s->counts + part * RADIX + b;
+            size_t c = *count;
+            *count = sum;
+            sum += c;
+        }
+
+        if (sum - bucket == s->n)
+            return false;
+    }
+
+    return true;
+}
+
+
+void dal_pparallelSort(DalPool *p, DynarrLO *d) {
+    size_t n = d->length;
+    size_t parts = MIN(p->size, n / DAL_PARALLEL_GRAIN);
+
+    if (parts <= 1) {
+        dal_psort(d);
+        return;
+    }
+
+    size_t *tmp = d->realloc(NULL, (n + parts * RADIX) * sizeof *tmp);
+    if (!tmp) {
+        d->error = DAL_ALLOCFAIL;
+        return;
+    }
+
+    RadixSort s = {d->arrayp, tmp, n, parts, 0, tmp + n};
+
+    for (; s.pass < PASSES; ++s.pass) {
+        run(p, parts, countPart, &s);
+
+        if (!prefixCounts(&s))
+            continue;
+
+        run(p, parts, distributePart, &s);
+
+        size_t *swapped = s.src;
+        s.src = s.dst;
+        s.dst = swapped;
+    }
+
+    if (s.src != d->arrayp)
+        memcpy(d->arrayp, s.src, n * sizeof *tmp);
+
+    d->free(tmp);
+    d->error = DAL_OK;
+}
+
+#endif // DAL_PRIMITIVE_SUPPORT
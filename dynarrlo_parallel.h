@@ -0,0 +1,239 @@
+//
+// Created by easy on 16.10.26.
+//
+
+#ifndef EASY_DYNARRLO_PARALLEL_H
+#define EASY_DYNARRLO_PARALLEL_H
+
+#include "dynarrlo.h"
+#include <pthread.h>
+#include <stdbool.h>
+
+
+#ifndef DAL_PARALLEL_GRAIN
+/**
+ * Number of elements that a parallel operation hands to a thread at once.
+ * Ranges of up to this many elements are processed by the calling thread
+ * alone. You may define this macro yourself when compiling the library.
+ */
+#define DAL_PARALLEL_GRAIN ((size_t) 1 << 14)
+#endif
+
+
+/**
+ * The queue of tasks of a single thread. Its definition is private to the
+ * implementation.
+ */
+typedef struct DalQueue DalQueue;
+
+
+/**
+ * A pool of worker threads that runs parallel operations on DynarrLO objects.
+ * The range of an operation is split into blocks of \p DAL_PARALLEL_GRAIN
+ * elements, which are distributed evenly across the threads. Threads that run
+ * out of blocks steal blocks from the others. The thread that starts an
+ * operation takes part in it and returns once all blocks have been
+ * processed.\n\n
+ *
+ * Callbacks receive a plain span of elements and must not call functions of
+ * the pool themselves. A pool must only be used by one thread at a time and
+ * must not be moved in memory, as its threads refer to it.\n\n
+ *
+ * Do not modify or access the fields of this struct manually.
+ */
+typedef struct DalPool {
+    /**
+     * Worker threads, one less than the number of threads of the pool.
+     */
+    pthread_t *threads;
+
+    /**
+     * One queue per thread of the pool, including the calling thread.
+     */
+    DalQueue *queues;
+
+    /**
+     * Number of threads of the pool, including the calling thread.
+     */
+    size_t size;
+
+    /**
+     * Guards the fields below.
+     */
+    pthread_mutex_t lock;
+
+    /**
+     * Signalled when a job is started or the pool is destroyed.
+     */
+    pthread_cond_t wake;
+
+    /**
+     * Signalled when the last worker thread has finished the current job.
+     */
+    pthread_cond_t done;
+
+    /**
+     * Incremented for every job.
+     */
+    size_t generation;
+
+    /**
+     * Number of worker threads still working on the current job.
+     */
+    size_t busy;
+
+    /**
+     * Set when the pool is destroyed.
+     */
+    bool stop;
+
+    /**
+     * Task of the current job, called with the index of a task.
+     */
+    void (*task) (size_t index, void *ctx);
+
+    /**
+     * Context of the current job.
+     */
+    void *ctx;
+
+    /**
+     * A \p realloc() function conforming to the C standard.
+     */
+    void *(*realloc) (void *ptr, size_t size);
+
+    /**
+     * A \p free() function conforming to the C standard.
+     */
+    void  (*free)    (void *ptr);
+} DalPool;
+
+
+/**
+ * Processes a contiguous part of an array.
+ * @param span Elements to process.
+ * @param first Index of the first element of \p span in the array.
+ * @param ctx Context passed to the parallel operation.
+ */
+typedef void (*DalSpanFn) (DalSpan span, size_t first, void *ctx);
+
+
+/**
+ * Reduces a contiguous part of an array to a single value.
+ * @param span Elements to reduce.
+ * @param first Index of the first element of \p span in the array.
+ * @param ctx Context passed to the parallel operation.
+ * @return Partial result.
+ */
+typedef size_t (*DalReduceFn) (DalSpan span, size_t first, void *ctx);
+
+
+/**
+ * Combines two partial results. Must be associative, need not be commutative.
+ * @param a Partial result of the lower part of the array.
+ * @param b Partial result of the upper part of the array.
+ * @param ctx Context passed to the parallel operation.
+ * @return Combined result.
+ */
+typedef size_t (*DalCombineFn) (size_t a, size_t b, void *ctx);
+
+
+/**
+ * Tries to create a pool of threads. Does nothing on failure.
+ * @param p Pointer to pool object that shall be initialised.
+ * @param threads Number of threads including the calling thread or 0 for one
+ * thread per online CPU.
+ * @param realloc realloc function conforming to the C standard.
+ * @param free free function conforming to the C standard.
+ * @return Error code indicating either success \p(DAL_OK), a null argument
+ * error \p(DAL_NULLARG) or failure to allocate memory or to start a thread
+ * \p (DAL_ALLOCFAIL) .
+ */
+DAL_ERROR dal_createPool(DalPool *p,
+                         size_t threads,
+                         void *(*realloc) (void *, size_t),
+                         void (*free) (void *));
+
+
+/**
+ * Stops and joins all worker threads, frees the pool and sets all struct
+ * fields to 0.
+ */
+void dal_destroyPool(DalPool *p);
+
+
+/**
+ * Calls \p fn for disjoint spans that together cover the elements in
+ * [ \p begin , \p end ) in parallel. Works for every element size. Error flag
+ * is set to \p DAL_OUTOFRANGE if the range exceeds the array, in which case it
+ * is cut off at length.
+ * @param begin Index of the first element (inclusive).
+ * @param end Index behind the last element (exclusive).
+ * @param fn Function to call for every span.
+ * @param ctx Context passed to \p fn .
+ */
+void dal_parallelFor(DalPool *p,
+                     DynarrLO *d,
+                     size_t begin,
+                     size_t end,
+                     DalSpanFn fn,
+                     void *ctx);
+
+
+/**
+ * Reduces the elements in [ \p begin , \p end ) to a single value in
+ * parallel. \p fn reduces spans to partial results, which are then combined
+ * in index order, so the result doesn't depend on the number of threads if
+ * \p combine is associative. Error flag is set to \p DAL_OUTOFRANGE if the
+ * range exceeds the array, in which case it is cut off at length, or to
+ * \p DAL_ALLOCFAIL if memory for the partial results couldn't be allocated,
+ * in which case \p identity is returned.
+ * @param begin Index of the first element (inclusive).
+ * @param end Index behind the last element (exclusive).
+ * @param identity Neutral element of \p combine , which is also the result
+ * for an empty range.
+ * @param fn Function reducing a span.
+ * @param combine Function combining two partial results.
+ * @param ctx Context passed to \p fn and \p combine .
+ * @return Combination of all partial results.
+ */
+size_t dal_parallelReduce(DalPool *p,
+                          DynarrLO *d,
+                          size_t begin,
+                          size_t end,
+                          size_t identity,
+                          DalReduceFn fn,
+                          DalCombineFn combine,
+                          void *ctx);
+
+
+#if DAL_PRIMITIVE_SUPPORT
+
+/**
+ * Replaces every value in [ \p begin , \p end ) with the result of \p fn in
+ * parallel. Error flag is set to \p DAL_OUTOFRANGE if the range exceeds the
+ * array, in which case it is cut off at length.
+ * @param begin Index of the first element (inclusive).
+ * @param end Index behind the last element (exclusive).
+ * @param fn Function mapping a value to its replacement.
+ * @param ctx Context passed to \p fn .
+ */
+void dal_pparallelTransform(DalPool *p,
+                            DynarrLO *d,
+                            size_t begin,
+                            size_t end,
+                            size_t (*fn) (size_t val, void *ctx),
+                            void *ctx);
+
+
+/**
+ * Parallel version of \p dal_psort() . Every thread counts and distributes the
+ * values of its own part of the array, so the sort remains stable. Sets error
+ * flag to \p DAL_ALLOCFAIL if the scratch buffer couldn't be allocated with
+ * the \p realloc() function of the DynarrLO, in which case the array is not
+ * sorted.
+ */
+void dal_pparallelSort(DalPool *p, DynarrLO *d);
+
+#endif // DAL_PRIMITIVE_SUPPORT
+#endif // EASY_DYNARRLO_PARALLEL_H
@@ -0,0 +1,598 @@
+//
+// Created by easy on 16.10.26.
+//
+
+
+#include "dynarrlo_scan.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+
+#if DAL_PRIMITIVE_SUPPORT && defined(__x86_64__) && __SIZEOF_SIZE_T__ == 8 && \
+    (defined(__GNUC__) || defined(__clang__))
+#define SCAN_X86 1
+#include <immintrin.h>
+#else
+#define SCAN_X86 0
+#endif
+
+
+#if DAL_PRIMITIVE_SUPPORT
+
+/**
+ * One implementation of every kernel. Searches return n if nothing was found,
+ * min and max return the neutral element of their operation if n is 0.
+ */
+typedef struct Kernels {
+    size_t (*find)      (const size_t *a, size_t n, size_t val);
+    size_t (*findLast)  (const size_t *a, size_t n, size_t val);
+    size_t (*count)     (const size_t *a, size_t n, size_t val);
+    size_t (*min)       (const size_t *a, size_t n);
+    size_t (*max)       (const size_t *a, size_t n);
+    size_t (*sum)       (const size_t *a, size_t n);
+    void   (*prefixSum) (size_t *a, size_t n, size_t carry);
+} Kernels;
+
+
+
+static size_t findScalar(const size_t *a, size_t n, size_t val) {
+    size_t i = 0;
+
+    while (i < n && a[i] != val)
+        ++i;
+
+    return i;
+}
+
+
+static size_t findLastScalar(const size_t *a, size_t n, size_t val) {
+    for (size_t i = n; i--;)
+        if (a[i] == val)
+            return i;
+
+    return n;
+}
+
+
+static size_t countScalar(const size_t *a, size_t n, size_t val) {
+    size_t count = 0;
+
+    for (size_t i = 0; i < n; ++i)
+        count += a[i] == val;
+
+    return count;
+}
+
+
+static size_t minScalar(const size_t *a, size_t n) {
+    size_t min = SIZE_MAX;
+
+    for (size_t i = 0; i < n; ++i)
+        min = a[i] < min ? a[i] : min;
+
+    return min;
+}
+
+
+static size_t maxScalar(const size_t *a, size_t n) {
+    size_t max = 0;
+
+    for (size_t i = 0; i < n; ++i)
+        max = a[i] > max ? a[i] : max;
+
+    return max;
+}
+
+
+static size_t sumScalar(const size_t *a, size_t n) {
+    size_t sum = 0;
+
+    for (size_t i = 0; i < n; ++i)
+        sum += a[i];
+
+    return sum;
+}
+
+
+static void prefixSumScalar(size_t *a, size_t n, size_t carry) {
+    for (size_t i = 0; i < n; ++i)
+        a[i] = carry += a[i];
+}
+
+
+static Kernels kernels = {
+    findScalar,
+    findLastScalar,
+    countScalar,
+    minScalar,
+    maxScalar,
+    sumScalar,
+    prefixSumScalar
+};
+
+
+
+#if SCAN_X86
+
+// Index of the lowest set bit of a non-zero mask.
+static size_t lowBit(unsigned mask) {
+    return (size_t) __builtin_ctz(mask);
+}
+
+
+// Index of the highest set bit of a non-zero mask.
+static size_t highBit(unsigned mask) {
+    return (size_t) (31 - __builtin_clz(mask));
+}
+
+
+/*
+ * SSE2 kernels, 2 elements per vector. SSE2 has no 64 bit comparison, so
+ * equality is derived from two 32 bit comparisons. Unsigned min and max have
+ * no SSE2 counterpart and stay scalar.
+ */
+
+static __m128i load128(const size_t *a) {
+    return _mm_loadu_si128((const __m128i *) a);
+}
+
+
+// All bits of a lane are set iff the lane of x equals the one of v.
+static __m128i cmpeq128(__m128i x, __m128i v) {
+    __m128i eq = _mm_cmpeq_epi32(x, v);
+    return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+
+static unsigned mask128(__m128i eq) {
+    return (unsigned) _mm_movemask_pd(_mm_castsi128_pd(eq));
+}
+
+
+static size_t sum128(__m128i x) {
+    x = _mm_add_epi64(x, _mm_unpackhi_epi64(x, x));
+    return (size_t) _mm_cvtsi128_si64(x);
+}
+
+
+static size_t findSSE2(const size_t *a, size_t n, size_t val) {
+    __m128i v = _mm_set1_epi64x((long long) val);
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        unsigned mask = mask128(cmpeq128(load128(a + i), v)) |
+                        mask128(cmpeq128(load128(a + i + 2), v)) << 2;
+        if (mask)
+            return i + lowBit(mask);
+    }
+
+    return i + findScalar(a + i, n - i, val);
+}
+
+
+static size_t findLastSSE2(const size_t *a, size_t n, size_t val) {
+    __m128i v = _mm_set1_epi64x((long long) val);
+    size_t i = n;
+
+    for (; i >= 4; i -= 4) {
+        unsigned mask = mask128(cmpeq128(load128(a + i - 4), v)) |
+                        mask128(cmpeq128(load128(a + i - 2), v)) << 2;
+        if (mask)
+            return i - 4 + highBit(mask);
+    }
+
+    size_t index = findLastScalar(a, i, val);
+    return index < i ? index : n;
+}
+
+
+static size_t countSSE2(const size_t *a, size_t n, size_t val) {
+    __m128i v = _mm_set1_epi64x((long long) val);
+    __m128i count = _mm_setzero_si128();
+    size_t i = 0;
+
+    // A match is -1 in its lane
+    for (; i + 2 <= n; i += 2)
+        count = _mm_sub_epi64(count, cmpeq128(load128(a + i), v));
+
+    return sum128(count) + countScalar(a + i, n - i, val);
+}
+
+
+static size_t sumSSE2(const size_t *a, size_t n) {
+    __m128i sum0 = _mm_setzero_si128();
+    __m128i sum1 = _mm_setzero_si128();
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        sum0 = _mm_add_epi64(sum0, load128(a + i));
+        sum1 = _mm_add_epi64(sum1, load128(a + i + 2));
+    }
+
+    return sum128(_mm_add_epi64(sum0, sum1)) + sumScalar(a + i, n - i);
+}
+
+
+static void prefixSumSSE2(size_t *a, size_t n, size_t carry) {
+    __m128i c = _mm_set1_epi64x((long long) carry);
+    size_t i = 0;
+
+    for (; i + 2 <= n; i += 2) {
+        __m128i x = load128(a + i);
+        x = _mm_add_epi64(x, _mm_slli_si128(x, 8));
+        x = _mm_add_epi64(x, c);
+        _mm_storeu_si128((__m128i *) (a + i), x);
+        c = _mm_unpackhi_epi64(x, x);
+    }
+
+    prefixSumScalar(a + i, n - i, (size_t) _mm_cvtsi128_si64(c));
+}
+
+
+
+/*
+ * AVX2 kernels, 4 elements per vector. Unsigned comparisons are done as signed
+ * comparisons of values whose sign bit has been flipped.
+ */
+
+#define AVX2 __attribute__((target("avx2")))
+
+
+AVX2 static __m256i load256(const size_t *a) {
+    return _mm256_loadu_si256((const __m256i *) a);
+}
+
+
+AVX2 static unsigned mask256(__m256i eq) {
+    return (unsigned) _mm256_movemask_pd(_mm256_castsi256_pd(eq));
+}
+
+
+AVX2 static size_t sum256(__m256i x) {
+    __m128i lo = _mm256_castsi256_si128(x);
+    __m128i hi = _mm256_extracti128_si256(x, 1);
+    return sum128(_mm_add_epi64(lo, hi));
+}
+
+
+AVX2 static size_t findAVX2(const size_t *a, size_t n, size_t val) {
+    __m256i v = _mm256_set1_epi64x((long long) val);
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        unsigned mask = mask256(_mm256_cmpeq_epi64(load256(a + i), v)) |
+                        mask256(_mm256_cmpeq_epi64(load256(a + i + 4), v)) << 4;
+        if (mask)
+            return i + lowBit(mask);
+    }
+
+    return i + findScalar(a + i, n - i, val);
+}
+
+
+AVX2 static size_t findLastAVX2(const size_t *a, size_t n, size_t val) {
+    __m256i v = _mm256_set1_epi64x((long long) val);
+    size_t i = n;
+
+    for (; i >= 8; i -= 8) {
+        unsigned mask = mask256(_mm256_cmpeq_epi64(load256(a + i - 8), v)) |
+                        mask256(_mm256_cmpeq_epi64(load256(a + i - 4), v)) << 4;
+        if (mask)
+            return i - 8 + highBit(mask);
+    }
+
+    size_t index = findLastScalar(a, i, val);
+    return index < i ? index : n;
+}
+
+
+AVX2 static size_t countAVX2(const size_t *a, size_t n, size_t val) {
+    __m256i v = _mm256_set1_epi64x((long long) val);
+    __m256i count0 = _mm256_setzero_si256();
+    __m256i count1 = _mm256_setzero_si256();
+    size_t i = 0;
+
+    // A match is -1 in its lane
+    for (; i + 8 <= n; i += 8) {
+        count0 = _mm256_sub_epi64(count0,
+                                  _mm256_cmpeq_epi64(load256(a + i), v));
+        count1 = _mm256_sub_epi64(count1,
+                                  _mm256_cmpeq_epi64(load256(a + i + 4), v));
+    }
+
+    return sum256(_mm256_add_epi64(count0, count1)) +
+           countScalar(a + i, n - i, val);
+}
+
+
+// Signed view of unsigned lanes, preserving their order.
+AVX2 static __m256i flipSign(__m256i x) {
+    return _mm256_xor_si256(x, _mm256_set1_epi64x(INT64_MIN));
+}
+
+
+// Reduces lanes with flipped sign bits to their smallest or greatest value.
+AVX2 static size_t reduceFlipped(__m256i x, bool greatest) {
+    size_t lanes[4];
+    _mm256_storeu_si256((__m256i *) lanes, flipSign(x));
+
+    return greatest ? maxScalar(lanes, 4) : minScalar(lanes, 4);
+}
+
+
+AVX2 static size_t extremeAVX2(const size_t *a, size_t n, bool greatest) {
+    size_t head = n & 3;
+    size_t best = greatest ? maxScalar(a, head) : minScalar(a, head);
+
+    if (n < 4)
+        return best;
+
+    __m256i lanes = flipSign(load256(a + head));
+
+    for (size_t i = head + 4; i < n; i += 4) {
+        __m256i x = flipSign(load256(a + i));
+        __m256i gt = _mm256_cmpgt_epi64(lanes, x);
+        lanes = greatest ? _mm256_blendv_epi8(x, lanes, gt)
+                         : _mm256_blendv_epi8(lanes, x, gt);
+    }
+
+    size_t reduced = reduceFlipped(lanes, greatest);
+    return greatest ? (reduced > best ? reduced : best)
+                    : (reduced < best ? reduced : best);
+}
+
+
+AVX2 static size_t minAVX2(const size_t *a, size_t n) {
+    return extremeAVX2(a, n, false);
+}
+
+
+AVX2 static size_t maxAVX2(const size_t *a, size_t n) {
+    return extremeAVX2(a, n, true);
+}
+
+
+AVX2 static size_t sumAVX2(const size_t *a, size_t n) {
+    __m256i sum0 = _mm256_setzero_si256();
+    __m256i sum1 = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        sum0 = _mm256_add_epi64(sum0, load256(a + i));
+        sum1 = _mm256_add_epi64(sum1, load256(a + i + 4));
+    }
+
+    return sum256(_mm256_add_epi64(sum0, sum1)) + sumScalar(a + i, n - i);
+}
+
+
+AVX2 static void prefixSumAVX2(size_t *a, size_t n, size_t carry) {
+    __m256i zero = _mm256_setzero_si256();
+    __m256i c = _mm256_set1_epi64x((long long) carry);
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        __m256i x = load256(a + i);
+
+        // Shift lanes up by one and by two, filling in zeroes
+        __m256i t = _mm256_permute4x64_epi64(x, _MM_SHUFFLE(2, 1, 0, 0));
+        x = _mm256_add_epi64(x, _mm256_blend_epi32(t, zero, 0x03));
+        t = _mm256_permute4x64_epi64(x, _MM_SHUFFLE(1, 0, 0, 0));
+        x = _mm256_add_epi64(x, _mm256_blend_epi32(t, zero, 0x0F));
+
+        x = _mm256_add_epi64(x, c);
+        _mm256_storeu_si256((__m256i *) (a + i), x);
+        c = _mm256_permute4x64_epi64(x, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+
+    prefixSumScalar(a + i, n - i, (size_t) _mm256_extract_epi64(c, 0));
+}
+
+
+
+/*
+ * AVX-512 kernels, 8 elements per vector. Comparisons yield bit masks and
+ * unsigned min and max are native operations. Prefix sums are left to AVX2.
+ */
+
+#define AVX512 __attribute__((target("avx512f")))
+
+
+AVX512 static __m512i load512(const size_t *a) {
+    return _mm512_loadu_si512(a);
+}
+
+
+AVX512 static size_t findAVX512(const size_t *a, size_t n, size_t val) {
+    __m512i v = _mm512_set1_epi64((long long) val);
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        unsigned mask = _mm512_cmpeq_epu64_mask(load512(a + i), v) |
+                        _mm512_cmpeq_epu64_mask(load512(a + i + 8), v) << 8;
+        if (mask)
+            return i + lowBit(mask);
+    }
+
+    return i + findScalar(a + i, n - i, val);
+}
+
+
+AVX512 static size_t findLastAVX512(const size_t *a, size_t n, size_t val) {
+    __m512i v = _mm512_set1_epi64((long long) val);
+    size_t i = n;
+
+    for (; i >= 16; i -= 16) {
+        unsigned mask = _mm512_cmpeq_epu64_mask(load512(a + i - 16), v) |
+                        _mm512_cmpeq_epu64_mask(load512(a + i - 8), v) << 8;
+        if (mask)
+            return i - 16 + highBit(mask);
+    }
+
+    size_t index = findLastScalar(a, i, val);
+    return index < i ? index : n;
+}
+
+
+AVX512 static size_t countAVX512(const size_t *a, size_t n, size_t val) {
+    __m512i v = _mm512_set1_epi64((long long) val);
+    size_t count = 0;
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+        count += (size_t) __builtin_popcount(
+                _mm512_cmpeq_epu64_mask(load512(a + i), v));
+
+    return count + countScalar(a + i, n - i, val);
+}
+
+
+AVX512 static size_t minAVX512(const size_t *a, size_t n) {
+    __m512i min = _mm512_set1_epi64(-1);
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+        min = _mm512_min_epu64(min, load512(a + i));
+
+    size_t lanes = (size_t) _mm512_reduce_min_epu64(min);
+    size_t rest = minScalar(a + i, n - i);
+    return lanes < rest ? lanes : rest;
+}
+
+
+AVX512 static size_t maxAVX512(const size_t *a, size_t n) {
+    __m512i max = _mm512_setzero_si512();
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+        max = _mm512_max_epu64(max, load512(a + i));
+
+    size_t lanes = (size_t) _mm512_reduce_max_epu64(max);
+    size_t rest = maxScalar(a + i, n - i);
+    return lanes > rest ? lanes : rest;
+}
+
+
+AVX512 static size_t sumAVX512(const size_t *a, size_t n) {
+    __m512i sum0 = _mm512_setzero_si512();
+    __m512i sum1 = _mm512_setzero_si512();
+    size_t i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        sum0 = _mm512_add_epi64(sum0, load512(a + i));
+        sum1 = _mm512_add_epi64(sum1, load512(a + i + 8));
+    }
+
+    sum0 = _mm512_add_epi64(sum0, sum1);
+    __m256i lo = _mm512_castsi512_si256(sum0);
+    __m256i hi = _mm512_extracti64x4_epi64(sum0, 1);
+    return sum256(_mm256_add_epi64(lo, hi)) + sumScalar(a + i, n - i);
+}
+
+
+
+// Picks the widest kernels the CPU supports before main() runs.
+__attribute__((constructor)) static void selectKernels(void) {
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f")) {
+        kernels = (Kernels) {
+            findAVX512,
+            findLastAVX512,
+            countAVX512,
+            minAVX512,
+            maxAVX512,
+            sumAVX512,
+            prefixSumAVX2
+        };
+    } else if (__builtin_cpu_supports("avx2")) {
+        kernels = (Kernels) {
+            findAVX2,
+            findLastAVX2,
+            countAVX2,
+            minAVX2,
+            maxAVX2,
+            sumAVX2,
+            prefixSumAVX2
+        };
+    } else {
+        kernels = (Kernels) {
+            findSSE2,
+            findLastSSE2,
+            countSSE2,
+            minScalar,
+            maxScalar,
+            sumSSE2,
+            prefixSumSSE2
+        };
+    }
+}
+
+#endif // SCAN_X86
+
+
+
+size_t dal_find(DynarrLO *d, const void *obj) {
+    size_t index = kernels.find(d->arrayp, d->length, (size_t) obj);
+    d->error = index >= d->length;
+    return index;
+}
+
+
+size_t dal_pfind(DynarrLO *d, size_t val) {
+    size_t index = kernels.find(d->arrayp, d->length, val);
+    d->error = index >= d->length;
+    return index;
+}
+
+
+size_t dal_pfindLast(DynarrLO *d, size_t val) {
+    size_t index = kernels.findLast(d->arrayp, d->length, val);
+    d->error = index >= d->length;
+    return index;
+}
+
+
+size_t dal_pcount(DynarrLO *d, size_t val) {
+    d->error = DAL_OK;
+    return kernels.count(d->arrayp, d->length, val);
+}
+
+
+size_t dal_pmin(DynarrLO *d) {
+    d->error = !d->length;
+    size_t min = kernels.min(d->arrayp, d->length);
+    return d->length ? min : 0;
+}
+
+
+size_t dal_pmax(DynarrLO *d) {
+    d->error = !d->length;
+    return kernels.max(d->arrayp, d->length);
+}
+
+
+size_t dal_psum(DynarrLO *d) {
+    d->error = DAL_OK;
+    return kernels.sum(d->arrayp, d->length);
+}
+
+
+void dal_pprefixSum(DynarrLO *d) {
+    d->error = DAL_OK;
+    kernels.prefixSum(d->arrayp, d->length, 0);
+}
+
+#else
+
+size_t dal_find(DynarrLO *d, const void *obj) {
+    size_t i = 0;
+
+    while (i < d->length && d->array[i] != obj)
+        ++i;
+
+    d->error = i >= d->length;
+    return i;
+}
+
+#endif // DAL_PRIMITIVE_SUPPORT
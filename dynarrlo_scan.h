@@ -0,0 +1,95 @@
+//
+// Created by easy on 16.10.26.
+//
+
+#ifndef EASY_DYNARRLO_SCAN_H
+#define EASY_DYNARRLO_SCAN_H
+
+#include "dynarrlo.h"
+
+
+/*
+ * Search and reduction kernels that run over the whole array of a DynarrLO.
+ * They operate on the array directly instead of going through dal_pget() for
+ * every element, so a scan over millions of elements runs at memory bandwidth.
+ *
+ * On x86-64 with gcc or clang, every kernel has SSE2, AVX2 and AVX-512
+ * implementations. The best one supported by the CPU is selected once when the
+ * program is loaded. Other platforms use portable scalar kernels, which the
+ * compiler is free to vectorise on its own.
+ */
+
+
+/**
+ * Finds the first element that is equal to \p obj by comparing pointers. Only
+ * for DynarrLO objects created with \p dal_createDynarrLO() . Error flag is set
+ * to \p DAL_OUTOFRANGE if there is no such element.
+ * @param obj Object to look for.
+ * @return Index of the first element equal to \p obj or length if there is
+ * none.
+ */
+size_t dal_find(DynarrLO *d, const void *obj);
+
+
+#if DAL_PRIMITIVE_SUPPORT
+
+/**
+ * Primitive version of \p dal_find() .
+ * @param val Value to look for.
+ * @return Index of the first element equal to \p val or length if there is
+ * none.
+ */
+size_t dal_pfind(DynarrLO *d, size_t val);
+
+
+/**
+ * Finds the last element that is equal to \p val . Error flag is set to
+ * \p DAL_OUTOFRANGE if there is no such element.
+ * @param val Value to look for.
+ * @return Index of the last element equal to \p val or length if there is
+ * none.
+ */
+size_t dal_pfindLast(DynarrLO *d, size_t val);
+
+
+/**
+ * Counts the elements that are equal to \p val .
+ * @param val Value to count.
+ * @return Number of elements equal to \p val .
+ */
+size_t dal_pcount(DynarrLO *d, size_t val);
+
+
+/**
+ * Finds the smallest element. Error flag is set to \p DAL_OUTOFRANGE if the
+ * array is empty.
+ * @return Smallest element or 0 if the array is empty.
+ */
+size_t dal_pmin(DynarrLO *d);
+
+
+/**
+ * Finds the greatest element. Error flag is set to \p DAL_OUTOFRANGE if the
+ * array is empty.
+ * @return Greatest element or 0 if the array is empty.
+ */
+size_t dal_pmax(DynarrLO *d);
+
+
+/**
+ * Adds up all elements. The sum wraps around on overflow just like any other
+ * \p size_t arithmetic.
+ * @return Sum of all elements or 0 if the array is empty.
+ */
+size_t dal_psum(DynarrLO *d);
+
+
+/**
+ * Replaces every element with the sum of itself and all elements before it,
+ * i.e. computes the inclusive prefix sum in place. Sums wrap around on
+ * overflow.
+ */
+void dal_pprefixSum(DynarrLO *d);
+
+#endif // DAL_PRIMITIVE_SUPPORT
+#endif // EASY_DYNARRLO_SCAN_H
@@ -0,0 +1,407 @@
+//
+// Created by easy on 16.10.26.
+//
+
+
+#include "dynarrlo_seg.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+
+// Returns the lesser of the two arguments.
+#define MIN(a, b) ((a) <= (b) ? (a) : (b))
+// Returns the greater of the two arguments.
+#define MAX(a, b) ((a) >= (b) ? (a) : (b))
+
+
+/**
+ * A chunk and the number of segmented arrays sharing it. The directory points
+ * to the elements, so accessing an element doesn't need to know about the
+ * header.
+ */
+typedef struct Chunk {
+    atomic_size_t refs;
+    void *elems[];
+} Chunk;
+
+
+static size_t itemsToBytes(size_t n) {
+    return n * sizeof(void *);
+}
+
+
+static size_t chunkSize(const DalSegArray *s) {
+    return (size_t) 1 << s->shift;
+}
+
+
+static void **chunkAt(const DalSegArray *s, size_t chunk) {
+    return s->chunks.array[chunk];
+}
+
+
+static Chunk *headerOf(void **elems) {
+    return (Chunk *) ((unsigned char *) elems - offsetof(Chunk, elems));
+}
+
+
+// Allocates an unshared chunk.
+static void **newChunk(DalSegArray *s) {
+    Chunk *c = s->chunks.realloc(NULL, sizeof *c + itemsToBytes(chunkSize(s)));
+
+    if (!c)
+        return NULL;
+
+    atomic_init(&c->refs, 1);
+    return c->elems;
+}
+
+
+// Drops a reference to a chunk and frees it once it is no longer shared.
+static void releaseChunk(DalSegArray *s, size_t chunk) {
+    Chunk *c = headerOf(chunkAt(s, chunk));
+
+    if (atomic_fetch_sub_explicit(&c->refs, 1, memory_order_acq_rel) == 1)
+        s->chunks.free(c);
+}
+
+
+/**
+ * Replaces a shared chunk with a private copy of its elements.
+ * @return False iff memory allocation failed.
+ */
+static bool unshare(DalSegArray *s, size_t chunk) {
+    void **copy = newChunk(s);
+
+    if (!copy)
+        return false;
+
+    size_t first = chunk << s->shift;
+    size_t used = MIN(s->length - MIN(first, s->length), chunkSize(s));
+    memcpy(copy, chunkAt(s, chunk), itemsToBytes(used));
+    releaseChunk(s, chunk);
+    s->chunks.array[chunk] = copy;
+    return true;
+}
+
+
+/**
+ * Address of the element at index. Any index >= length is redirected to the
+ * padding element. The first chunk always exists, so index 0 may be used as a
+ * stand-in for invalid indices.
+ */
+static void **slot(DalSegArray *s, size_t index) {
+    bool valid = index < s->length;
+    size_t i = valid ? index : 0;
+    void **elem = chunkAt(s, i >> s->shift) + (i & (chunkSize(s) - 1));
+    return valid ? elem : &s->padding;
+}
+
+
+/**
+ * Address of the element at index for writing. Copies the chunk of the
+ * element first if it is shared with a snapshot. Any index >= length is
+ * redirected to the padding element.
+ * @return Address of the element or NULL if the chunk couldn't be copied.
+ */
+static void **writableSlot(DalSegArray *s, size_t index) {
+    size_t chunk = index >> s->shift;
+
+    if (index < s->length &&
+        atomic_load_explicit(&headerOf(chunkAt(s, chunk))->refs,
+                             memory_order_acquire) != 1 &&
+        !unshare(s, chunk))
+        return NULL;
+
+    return slot(s, index);
+}
+
+
+/**
+ * Makes dst share all chunks of src and sets its length to the one of src.
+ * The chunks of src are referenced before those of dst are released, as they
+ * may be the same.
+ */
+static void share(DalSegArray *dst, const DalSegArray *src) {
+    dst->error = DAL_OK;
+
+    if (dst == src)
+        return;
+
+    dal_reserve(&dst->chunks, src->chunks.length);
+    if (dst->chunks.error) {
+        dst->error = DAL_ALLOCFAIL;
+        return;
+    }
+
+    for (size_t i = 0; i < src->chunks.length; ++i)
+        atomic_fetch_add_explicit(&headerOf(chunkAt(src, i))->refs, 1,
+                                  memory_order_relaxed);
+
+    for (size_t i = 0; i < dst->chunks.length; ++i)
+        releaseChunk(dst, i);
+
+    dal_setLength(&dst->chunks, 0);
+    dal_appendMany(&dst->chunks, src->chunks.array, src->chunks.length);
+    dst->length = src->length;
+    dst->shift = src->shift;
+    dst->padding = NULL;
+}
+
+
+/**
+ * Allocates another chunk if the array is full.
+ * @return True iff memory allocation failed.
+ */
+static bool growSeg(DalSegArray *s) {
+    if (s->length < dal_segCap(s))
+        return false;
+
+    dal_segReserve(s, s->length + 1);
+    return s->error;
+}
+
+
+
+DAL_ERROR dal_createSegArray(DalSegArray *s,
+                             size_t capacity,
+                             size_t chunkShift,
+                             void *(*realloc) (void *, size_t),
+                             void (*free) (void *)) {
+
+    if (!s)
+        return DAL_NULLARG;
+
+    DAL_ERROR error = dal_createDynarrLO(&s->chunks, 0, realloc, free);
+    if (error)
+        return error;
+
+    s->length = 0;
+    s->shift = MAX(chunkShift, 1);
+    s->error = DAL_OK;
+    s->padding = NULL;
+
+    dal_segReserve(s, MAX(capacity, 1));
+
+    if (s->error) {
+        dal_destroySegArray(s);
+        return DAL_ALLOCFAIL;
+    }
+
+    return DAL_OK;
+}
+
+
+void dal_destroySegArray(DalSegArray *s) {
+    for (size_t i = 0; i < s->chunks.length; ++i)
+        releaseChunk(s, i);
+
+    dal_destroyDynarrLO(&s->chunks);
+    *s = (DalSegArray) {0};
+}
+
+
+void dal_segReserve(DalSegArray *s, size_t num) {
+    size_t chunks = (num >> s->shift) + !!(num & (chunkSize(s) - 1));
+    s->error = DAL_OK;
+
+    dal_reserve(&s->chunks, chunks);
+    if (s->chunks.error) {
+        s->error = DAL_ALLOCFAIL;
+        return;
+    }
+
+    while (s->chunks.length < chunks) {
+        void **chunk = newChunk(s);
+
+        if (!chunk) {
+            s->error = DAL_ALLOCFAIL;
+            return;
+        }
+
+        dal_append(&s->chunks, chunk);
+    }
+}
+
+
+void dal_segShrinkToFit(DalSegArray *s) {
+    size_t used = (s->length >> s->shift) + !!(s->length & (chunkSize(s) - 1));
+    used = MAX(used, 1);
+    s->error = DAL_OK;
+
+    for (size_t i = used; i < s->chunks.length; ++i)
+        releaseChunk(s, i);
+
+    dal_setLength(&s->chunks, used);
+    dal_shrinkToFit(&s->chunks);
+}
+
+
+DalSpan dal_segChunk(DalSegArray *s, size_t chunk) {
+    if ((s->error = chunk >= s->chunks.length ||
+                    chunk << s->shift >= s->length))
+        return (DalSpan) {NULL, 0};
+
+    size_t first = chunk << s->shift;
+
+    if (!writableSlot(s, first)) {
+        s->error = DAL_ALLOCFAIL;
+        return (DalSpan) {NULL, 0};
+    }
+
+    return (DalSpan) {chunkAt(s, chunk), MIN(s->length - first, chunkSize(s))};
+}
+
+
+void dal_segAppend(DalSegArray *s, void *obj) {
+    if (growSeg(s))
+        return;
+
+    ++s->length;
+    void **elem = writableSlot(s, s->length - 1);
+
+    if (!elem) {
+        --s->length;
+        s->error = DAL_ALLOCFAIL;
+        return;
+    }
+
+    s->error = DAL_OK;
+    *elem = obj;
+}
+
+
+void *dal_segGet(DalSegArray *s, size_t index) {
+    s->error = index >= s->length;
+    return *slot(s, index);
+}
+
+
+void **dal_segRef(DalSegArray *s, size_t index) {
+    void **elem = writableSlot(s, index);
+
+    if (!elem) {
+        s->error = DAL_ALLOCFAIL;
+        return NULL;
+    }
+
+    s->error = index >= s->length;
+    return index < s->length ? elem : NULL;
+}
+
+
+void dal_segWrite(DalSegArray *s,
+                  size_t index,
+                  void *obj) {
+
+    void **elem = writableSlot(s, index);
+
+    if (!elem) {
+        s->error = DAL_ALLOCFAIL;
+        return;
+    }
+
+    s->error = index >= s->length;
+    *elem = obj;
+    s->padding = NULL;
+}
+
+
+void *dal_segPop(DalSegArray *s) {
+    s->error = !s->length;
+    size_t normlen = s->length - !!s->length;
+    void *obj = *slot(s, normlen);
+    s->length = normlen;
+    return obj;
+}
+
+
+void dal_segRemoveLastMany(DalSegArray *s, size_t amount) {
+    s->error = amount > s->length;
+    amount = MIN(amount, s->length);
+    s->length -= amount;
+}
+
+
+DAL_ERROR dal_segClone(DalSegArray *dst, const DalSegArray *src) {
+    if (!dst || !src)
+        return DAL_NULLARG;
+
+    DalSegArray tmp = {.shift = src->shift};
+    DAL_ERROR error = dal_createDynarrLO(&tmp.chunks, src->chunks.length,
+                                         src->chunks.realloc,
+                                         src->chunks.free);
+    if (error)
+        return error;
+
+    share(&tmp, src);
+    *dst = tmp;
+    return DAL_OK;
+}
+
+
+void dal_segSnapshot(DalSegArray *snap, const DalSegArray *s) {
+    share(snap, s);
+}
+
+
+void dal_segRestore(DalSegArray *s, const DalSegArray *snap) {
+    share(s, snap);
+}
+
+
+
+#if DAL_PRIMITIVE_SUPPORT
+
+void dal_psegAppend(DalSegArray *s, size_t val) {
+    if (growSeg(s))
+        return;
+
+    ++s->length;
+    void **elem = writableSlot(s, s->length - 1);
+
+    if (!elem) {
+        --s->length;
+        s->error = DAL_ALLOCFAIL;
+        return;
+    }
+
+    s->error = DAL_OK;
+    *(size_t *) elem = val;
+}
+
+
+size_t dal_psegGet(DalSegArray *s, size_t index) {
+    s->error = index >= s->length;
+    return *(size_t *) slot(s, index);
+}
+
+
+void dal_psegWrite(DalSegArray *s,
+                   size_t index,
+                   size_t val) {
+
+    void **elem = writableSlot(s, index);
+
+    if (!elem) {
+        s->error = DAL_ALLOCFAIL;
+        return;
+    }
+
+    s->error = index >= s->length;
+    *(size_t *) elem = val;
+    s->padding = NULL;
+}
+
+
+size_t dal_psegPop(DalSegArray *s) {
+    s->error = !s->length;
+    size_t normlen = s->length - !!s->length;
+    size_t val = *(size_t *) slot(s, normlen);
+    s->length = normlen;
+    return val;
+}
+
+#endif // DAL_PRIMITIVE_SUPPORT
@@ -0,0 +1,289 @@
+//
+// Created by easy on 16.10.26.
+//
+
+#ifndef EASY_DYNARRLO_SEG_H
+#define EASY_DYNARRLO_SEG_H
+
+#include "dynarrlo.h"
+
+
+/**
+ * A segmented array. Its elements are stored in chunks of a fixed power-of-two
+ * size, which are referenced by a directory. Growing the array allocates
+ * another chunk and appends it to the directory. Growth never copies existing
+ * elements, so there are no latency spikes due to reallocation of large
+ * arrays. Only the directory, which holds one pointer per chunk, is ever
+ * reallocated. The address of an element stays the same while it is part of
+ * the array, unless its chunk is shared with a clone, snapshot or restored
+ * array: the first write to a shared chunk moves it to a private copy, see
+ * below.\n\n
+ *
+ * Accessing an element costs one shift and one mask more than in a DynarrLO.
+ * The accessor functions are branchless just like their DynarrLO counterparts.
+ * Any index >= length is redirected to a padding element, so reads return
+ * NULL / 0 and writes are discarded.\n\n
+ *
+ * Like a DynarrLO, a segmented array stores either \p void* or, if available,
+ * \p size_t elements.\n\n
+ *
+ * Segmented arrays support copy-on-write snapshots. A snapshot shares all
+ * chunks of its array, which are reference counted, so taking one only costs
+ * time proportional to the number of chunks. Whichever array writes to a
+ * shared chunk first gets a private copy of it, so memory grows only by the
+ * chunks that are actually modified afterwards. Arrays sharing chunks may be
+ * used by different threads.\n\n
+ *
+ * Do not modify or access the fields of this struct manually.
+ */
+typedef struct DalSegArray {
+    /**
+     * Directory of chunks. Also holds the \p realloc() and \p free() functions.
+     */
+    DynarrLO chunks;
+
+    /**
+     * Current amount of elements in this segmented array.
+     */
+    size_t length;
+
+    /**
+     * Every chunk holds 2 to the power of \p shift elements.
+     */
+    size_t shift;
+
+    /**
+     * Error flag.
+     */
+    DAL_ERROR error;
+
+    /**
+     * Padding element, target of all out-of-range accesses. Always NULL / 0.
+     */
+    void *padding;
+} DalSegArray;
+
+
+/**
+ * Simple accessor function to retrieve the length of a segmented array.\n\n
+ * This function is declared \p static \p inline .
+ * @return Current amount of elements in this segmented array.
+ */
+static inline size_t dal_segLen(const DalSegArray *s) {
+    return s->length;
+}
+
+
+/**
+ * Simple accessor function to retrieve the capacity of a segmented array.\n\n
+ * This function is declared \p static \p inline .
+ * @return Number of elements that fit into the allocated chunks.
+ */
+static inline size_t dal_segCap(const DalSegArray *s) {
+    return s->chunks.length << s->shift;
+}
+
+
+/**
+ * Simple accessor function to retrieve the value of the error flag of a
+ * segmented array.\n\n
+ * This function is declared \p static \p inline .
+ * @return Error flag value.
+ */
+static inline DAL_ERROR dal_segErr(const DalSegArray *s) {
+    return s->error;
+}
+
+
+/**
+ * Tries to create a segmented array. At least one chunk is always allocated.
+ * Does nothing on failure.
+ * @param s Pointer to segmented array object that shall be initialised.
+ * @param capacity Desired starting capacity, rounded up to whole chunks.
+ * @param chunkShift Every chunk holds 2 to the power of \p chunkShift
+ * elements. Values below 1 are treated as 1.
+ * @param realloc realloc function conforming to the C standard.
+ * @param free free function conforming to the C standard.
+ * @return Error code indicating either success \p(DAL_OK), a null argument
+ * error \p(DAL_NULLARG) or failure to allocate the requested amount of memory
+ * \p (DAL_ALLOCFAIL) .
+ */
+DAL_ERROR dal_createSegArray(DalSegArray *s,
+                             size_t capacity,
+                             size_t chunkShift,
+                             void *(*realloc) (void *, size_t),
+                             void (*free) (void *));
+
+
+/**
+ * Frees all chunks and the directory of this segmented array and sets all
+ * struct fields to 0. Elements residing in the array are not automatically
+ * freed.
+ */
+void dal_destroySegArray(DalSegArray *s);
+
+
+/**
+ * Allocates chunks until the array can hold at least \p num elements. Never
+ * copies elements.
+ *
+ * Sets error flag to \p DAL_ALLOCFAIL if memory couldn't be allocated. The
+ * chunks allocated until then are kept.
+ * @param num Number of elements the array must be able to hold.
+ */
+void dal_segReserve(DalSegArray *s, size_t num);
+
+
+/**
+ * Frees all chunks that hold no element, keeping at least one chunk.
+ */
+void dal_segShrinkToFit(DalSegArray *s);
+
+
+/**
+ * Gets the elements of a single chunk, which are contiguous in memory. Use
+ * this to run loops over plain pointers, one chunk at a time. A chunk shared
+ * with a snapshot is copied first, so the span may be written to. Error flag is
+ * set to \p DAL_OUTOFRANGE if the chunk holds no element or to
+ * \p DAL_ALLOCFAIL if it couldn't be copied.
+ * @param chunk Index of the chunk, i.e. index of its first element divided by
+ * the chunk size.
+ * @return Span of the elements of the chunk that are part of the array.
+ */
+DalSpan dal_segChunk(DalSegArray *s, size_t chunk);
+
+
+/**
+ * Appends an object to the back of the array. Allocates another chunk if
+ * needed or copies the last one if it is shared with a snapshot. Error flag is
+ * set to \p DAL_ALLOCFAIL if memory couldn't be allocated.
+ * @param obj Object to append.
+ */
+void dal_segAppend(DalSegArray *s, void *obj);
+
+
+/**
+ * Gets the element at \p index. Error flag is set to \p DAL_OUTOFRANGE if
+ * \p index >= length.
+ * @param index Index to access.
+ * @return Element at \p index or NULL if \p index >= length.
+ */
+void *dal_segGet(DalSegArray *s, size_t index);
+
+
+/**
+ * Gets the address of the element at \p index , which stays valid for as long
+ * as the element is part of the array. Taking a snapshot makes the chunk of the
+ * element shared again, so don't write through the address afterwards and get
+ * a new one instead. Error flag is set to \p DAL_OUTOFRANGE if
+ * \p index >= length or to \p DAL_ALLOCFAIL if the chunk of the element was
+ * shared and couldn't be copied.
+ * @param index Index to access.
+ * @return Address of the element at \p index or NULL if \p index >= length.
+ */
+void **dal_segRef(DalSegArray *s, size_t index);
+
+
+/**
+ * Writes an object into the array. Does nothing if \p index >= length, in
+ * which case error flag is set to \p DAL_OUTOFRANGE, or if the chunk of the
+ * element was shared and couldn't be copied, in which case error flag is set to
+ * \p DAL_ALLOCFAIL.
+ * @param index Index to overwrite.
+ * @param obj Object that shall be written at the \p index.
+ */
+void dal_segWrite(DalSegArray *s,
+                  size_t index,
+                  void *obj);
+
+
+/**
+ * Removes the hindmost element and returns it. Chunks are not freed. Error
+ * flag is set to \p DAL_OUTOFRANGE if array is empty.
+ * @return Hindmost element or NULL if array is empty.
+ */
+void *dal_segPop(DalSegArray *s);
+
+
+/**
+ * Removes multiple elements from the back of the array. Chunks are not freed.
+ * Error flag is set to \p DAL_OUTOFRANGE if \p amount > length.
+ * @param amount Number of elements to remove from back.
+ */
+void dal_segRemoveLastMany(DalSegArray *s, size_t amount);
+
+
+/**
+ * Tries to create a copy-on-write copy of \p src , which shares all chunks of
+ * \p src until either of them is written to. Takes time proportional to the
+ * number of chunks. Does nothing on failure.
+ * @param dst Pointer to segmented array object that shall be initialised.
+ * @param src Segmented array to copy, which is not modified.
+ * @return Error code indicating either success \p(DAL_OK), a null argument
+ * error \p(DAL_NULLARG) or failure to allocate the directory
+ * \p (DAL_ALLOCFAIL) .
+ */
+DAL_ERROR dal_segClone(DalSegArray *dst, const DalSegArray *src);
+
+
+/**
+ * Takes a snapshot of \p s into \p snap , which must have been created before
+ * with the same \p realloc() and \p free() functions, e.g. by
+ * \p dal_segClone() . The previous contents of \p snap are discarded
+ * and its directory is reused, so taking checkpoints over and over again
+ * doesn't allocate memory unless \p s has grown. Error flag of \p snap is set
+ * to \p DAL_ALLOCFAIL if its directory couldn't be grown, in which case it is
+ * not modified.
+ * @param snap Segmented array receiving the snapshot.
+ * @param s Segmented array to take a snapshot of, which is not modified.
+ */
+void dal_segSnapshot(DalSegArray *snap, const DalSegArray *s);
+
+
+/**
+ * Rolls \p s back to the snapshot \p snap in time proportional to the number
+ * of chunks. Both must use the same \p realloc() and \p free() functions.
+ * \p snap remains a valid snapshot, so it may be restored again.
+ * Error flag of \p s is set to \p DAL_ALLOCFAIL if its directory couldn't be
+ * grown, in which case it is not modified.
+ * @param s Segmented array to roll back.
+ * @param snap Snapshot to restore, which is not modified.
+ */
+void dal_segRestore(DalSegArray *s, const DalSegArray *snap);
+
+
+#if DAL_PRIMITIVE_SUPPORT
+
+/**
+ * Primitive version of \p dal_segAppend() .
+ * @param val Value to append.
+ */
+void dal_psegAppend(DalSegArray *s, size_t val);
+
+
+/**
+ * Primitive version of \p dal_segGet() .
+ * @param index Index to access.
+ * @return Value at \p index or 0 if \p index >= length.
+ */
+size_t dal_psegGet(DalSegArray *s, size_t index);
+
+
+/**
+ * Primitive version of \p dal_segWrite() .
+ * @param index Index to overwrite.
+ * @param val Value that shall be written at the \p index.
+ */
+void dal_psegWrite(DalSegArray *s,
+                   size_t index,
+                   size_t val);
+
+
+/**
+ * Primitive version of \p dal_segPop() .
+ * @return Hindmost value or 0 if array is empty.
+ */
+size_t dal_psegPop(DalSegArray *s);
+
+#endif // DAL_PRIMITIVE_SUPPORT
+#endif // EASY_DYNARRLO_SEG_H
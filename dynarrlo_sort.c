@@ -0,0 +1,448 @@
+//
+// Created by easy on 16.10.26.
+//
+
+
+#include "dynarrlo_sort.h"
+#include <limits.h>
+#include <stdbool.h>
+#include <string.h>
+
+
+// Arrays up to this length are sorted by insertion.
+#define SHORT_SORT 24
+
+// Bits of a value that a radix pass distributes by. 11 bits keep the
+// histogram of a pass within the L1 cache.
+#define RADIX_BITS 11
+#define RADIX (1 << RADIX_BITS)
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define PREFETCH(addr) ((void) 0)
+#endif
+
+
+static size_t itemsToBytes(size_t n) {
+    return n * sizeof(void *);
+}
+
+
+static void swap(void **a, void **b) {
+    void *tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+
+// Stable, so it also serves for the runs of merge sort.
+static void insertionSort(void **a, size_t n, DalCompare cmp) {
+    for (size_t i = 1; i < n; ++i) {
+        void *obj = a[i];
+        size_t j = i;
+
+        for (; j && cmp(obj, a[j - 1]) < 0; --j)
+            a[j] = a[j - 1];
+
+        a[j] = obj;
+    }
+}
+
+
+static void siftDown(void **a, size_t root, size_t n, DalCompare cmp) {
+    for (size_t child; (child = 2 * root + 1) < n; root = child) {
+        child += child + 1 < n && cmp(a[child], a[child + 1]) < 0;
+
+        if (cmp(a[root], a[child]) >= 0)
+            return;
+
+        swap(a + root, a + child);
+    }
+}
+
+
+static void heapSort(void **a, size_t n, DalCompare cmp) {
+    for (size_t i = n / 2; i--;)
+        siftDown(a, i, n, cmp);
+
+    for (size_t i = n; --i;) {
+        swap(a, a + i);
+        siftDown(a, 0, i, cmp);
+    }
+}
+
+
+/**
+ * Hoare partition around the median of the first, middle and last object.
+ * @return Length of the left part, which is at least 1 and less than n.
+ */
+static size_t partition(void **a, size_t n, DalCompare cmp) {
+    size_t mid = (n - 1) / 2;
+
+    if (cmp(a[mid], a[0]) < 0)
+        swap(a + mid, a);
+    if (cmp(a[n - 1], a[mid]) < 0)
+        swap(a + n - 1, a + mid);
+    if (cmp(a[mid], a[0]) < 0)
+        swap(a + mid, a);
+
+    void *pivot = a[mid];
+    size_t i = 0;
+    size_t j = n - 1;
+
+    for (;;) {
+        while (cmp(a[i], pivot) < 0)
+            ++i;
+        while (cmp(pivot, a[j]) < 0)
+            --j;
+
+        if (i >= j)
+            return j + 1;
+
+        swap(a + i++, a + j--);
+    }
+}
+
+
+static void introSort(void **a, size_t n, size_t depth, DalCompare cmp) {
+    while (n > SHORT_SORT) {
+        if (!depth--) {
+            heapSort(a, n, cmp);
+            return;
+        }
+
+        size_t left = partition(a, n, cmp);
+
+        // Recurse into the shorter part to bound the stack depth
+        if (left < n - left) {
+            introSort(a, left, depth, cmp);
+            a += left;
+            n -= left;
+        } else {
+            introSort(a + left, n - left, depth, cmp);
+            n = left;
+        }
+    }
+
+    insertionSort(a, n, cmp);
+}
+
+
+// Merges the sorted ranges a[0, mid) and a[mid, n) into dst.
+static void merge(void **dst,
+                  void **a,
+                  size_t mid,
+                  size_t n,
+                  DalCompare cmp) {
+
+    size_t i = 0;
+    size_t j = mid;
+
+    for (size_t k = 0; k < n; ++k) {
+        // Taking from the left part on ties keeps the sort stable
+        int right = i >= mid || (j < n && cmp(a[j], a[i]) < 0);
+        dst[k] = right ? a[j++] : a[i++];
+    }
+}
+
+
+static void mergeSort(void **a, void **tmp, size_t n, DalCompare cmp) {
+    for (size_t lo = 0; lo < n; lo += SHORT_SORT)
+        insertionSort(a + lo, n - lo < SHORT_SORT ? n - lo : SHORT_SORT, cmp);
+
+    void **src = a;
+    void **dst = tmp;
+
+    for (size_t width = SHORT_SORT; width < n; width *= 2) {
+        for (size_t lo = 0; lo < n; lo += 2 * width) {
+            size_t len = n - lo < 2 * width ? n - lo : 2 * width;
+            size_t mid = len < width ? len : width;
+            merge(dst + lo, src + lo, mid, len, cmp);
+        }
+
+        void **swapped = src;
+        src = dst;
+        dst = swapped;
+    }
+
+    if (src != a)
+        memcpy(a, src, itemsToBytes(n));
+}
+
+
+
+void dal_sort(DynarrLO *d, DalCompare cmp) {
+    size_t depth = 0;
+
+    for (size_t n = d->length; n > 1; n /= 2)
+        depth += 2;
+
+    introSort(d->array, d->length, depth, cmp);
+    d->error = DAL_OK;
+}
+
+
+void dal_stableSort(DynarrLO *d, DalCompare cmp) {
+    d->error = DAL_OK;
+
+    if (d->length <= SHORT_SORT) {
+        insertionSort(d->array, d->length, cmp);
+        return;
+    }
+
+    void **tmp = d->realloc(NULL, itemsToBytes(d->length));
+    if (!tmp) {
+        d->error = DAL_ALLOCFAIL;
+        return;
+    }
+
+    mergeSort(d->array, tmp, d->length, cmp);
+    d->free(tmp);
+}
+
+
+
+#if DAL_PRIMITIVE_SUPPORT
+
+#define PASSES ((sizeof(size_t) * CHAR_BIT + RADIX_BITS - 1) / RADIX_BITS)
+
+
+static size_t trailingOnes(size_t n) {
+#if defined(__GNUC__) || defined(__clang__)
+    unsigned long long zeros = ~(unsigned long long) n;
+    return zeros ? (size_t) __builtin_ctzll(zeros) : sizeof n * CHAR_BIT;
+#else
+    size_t ones = 0;
+
+    for (; n & 1; n >>= 1)
+        ++ones;
+
+    return ones;
+#endif
+}
+
+
+static size_t digit(size_t val, size_t pass) {
+    return (val >> pass * RADIX_BITS) & (RADIX - 1);
+}
+
+
+static void pinsertionSort(size_t *a, size_t n) {
+    for (size_t i = 1; i < n; ++i) {
+        size_t val = a[i];
+        size_t j = i;
+
+        for (; j && val < a[j - 1]; --j)
+            a[j] = a[j - 1];
+
+        a[j] = val;
+    }
+}
+
+
+/**
+ * Sorts a by distributing its values between a and tmp. The histograms of all
+ * passes are gathered in a single read of the array.
+ * @param counts PASSES * RADIX zeroed counters.
+ */
+static void radixSort(size_t *a, size_t *tmp, size_t n, size_t *counts) {
+    for (size_t i = 0; i < n; ++i)
+        for (size_t pass = 0; pass < PASSES; ++pass)
+            ++counts[pass * RADIX + digit(a[i], pass)];
+
+    size_t *src = a;
+    size_t *dst = tmp;
+
+    for (size_t pass = 0; pass < PASSES; ++pass) {
+        size_t *offsets = counts + pass * RADIX;
+
+        // Nothing to distribute if all values share this digit
+        if (offsets[digit(a[0], pass)] == n)
+            continue;
+
+        for (size_t b = 0, sum = 0; b < RADIX; ++b) {
+            size_t count = offsets[b];
+            offsets[b] = sum;
+            sum += count;
+        }
+
+        for (size_t i = 0; i < n; ++i)
+            dst[offsets[digit(src[i], pass)]++] = src[i];
+
+        size_t *swapped = src;
+        src = dst;
+        dst = swapped;
+    }
+
+    if (src != a)
+        memcpy(a, src, n * sizeof *a);
+}
+
+
+void dal_psort(DynarrLO *d) {
+    d->error = DAL_OK;
+
+    if (d->length <= SHORT_SORT) {
+        pinsertionSort(d->arrayp, d->length);
+        return;
+    }
+
+    // The counters are too large for the stack and go behind the scratch buffer
+    size_t scratch = d->length + PASSES * RADIX;
+    size_t *tmp = d->realloc(NULL, scratch * sizeof *tmp);
+    if (!tmp) {
+        d->error = DAL_ALLOCFAIL;
+        return;
+    }
+
+    size_t *counts = tmp + d->length;
+    memset(counts, 0, PASSES * RADIX * sizeof *counts);
+    radixSort(d->arrayp, tmp, d->length, counts);
+    d->free(tmp);
+}
+
+
+
+/**
+ * Branchless binary search for the first element that is not ordered before
+ * val. With inclusive set, elements equal to val are ordered before it.
+ */
+static size_t bound(const size_t *a, size_t n, size_t val, bool inclusive) {
+    if (!n)
+        return 0;
+
+    const size_t *base = a;
+
+    while (n > 1) {
+        size_t half = n / 2;
+        PREFETCH(base + half / 2);
+        PREFETCH(base + half + half / 2);
+        base += (base[half] < val || (inclusive & (base[half] == val))) * half;
+        n -= half;
+    }
+
+    return (size_t) (base - a) + (*base < val || (inclusive & (*base == val)));
+}
+
+
+size_t dal_plowerBound(DynarrLO *d, size_t val) {
+    d->error = DAL_OK;
+    return bound(d->arrayp, d->length, val, false);
+}
+
+
+size_t dal_pupperBound(DynarrLO *d, size_t val) {
+    d->error = DAL_OK;
+    return bound(d->arrayp, d->length, val, true);
+}
+
+
+size_t dal_pinsertSorted(DynarrLO *d, size_t val) {
+    size_t index = bound(d->arrayp, d->length, val, true);
+    dal_pinsert(d, index, val);
+    return index;
+}
+
+
+size_t dal_peraseValue(DynarrLO *d, size_t val) {
+    size_t lower = bound(d->arrayp, d->length, val, false);
+    size_t upper = bound(d->arrayp, d->length, val, true);
+    d->error = DAL_OK;
+
+    if (upper > lower)
+        dal_removeMany(d, lower, upper);
+
+    return upper - lower;
+}
+
+
+
+/**
+ * In-order rank of node k of an Eytzinger tree with n nodes whose last level
+ * starts at node last. The rank in a perfect tree is corrected by the number
+ * of nodes missing from the last level that would be ordered before node k.
+ */
+static size_t rankOf(size_t k, size_t n, size_t last) {
+    size_t height = 0;
+
+    while (k << height < last)
+        ++height;
+
+    // Rank in a perfect tree, derived from the leftmost descendant of node k
+    // on the last level
+    size_t leftmost = k << height;
+    size_t perfect = 2 * (leftmost - last) + ((size_t) 1 << height) - 1;
+
+    // Node last + i of the last level has rank 2 * i in a perfect tree
+    size_t present = n - last + 1;
+    size_t before = (perfect + 1) / 2;
+    return perfect - (before > present ? before - present : 0);
+}
+
+
+static size_t indexBound(const DalSearchIndex *ix, size_t val, bool inclusive) {
+    const size_t *tree = ix->tree.arrayp;
+    size_t n = ix->tree.length - 1;
+    size_t k = 1;
+
+    while (k <= n) {
+        // The 16 descendants four levels down share two cache lines
+        PREFETCH(tree + 16 * k);
+        k = 2 * k + (tree[k] < val || (inclusive & (tree[k] == val)));
+    }
+
+    // Undo the final turns to the right to get to the node of the result
+    k >>= trailingOnes(k) + 1;
+
+    return k ? rankOf(k, n, ix->lastLevel) : n;
+}
+
+
+DAL_ERROR dal_pcreateSearchIndex(DalSearchIndex *ix, const DynarrLO *d) {
+    if (!ix || !d)
+        return DAL_NULLARG;
+
+    size_t n = d->length;
+    DAL_ERROR error = dal_createDynarrLOAligned(&ix->tree,
+                                                n + 1,
+                                                sizeof(size_t),
+                                                64,
+                                                d->realloc,
+                                                d->free);
+    if (error)
+        return error;
+
+    // Searches touch pages all over the tree, which is never reallocated
+    dal_useHugePages(&ix->tree);
+    ix->lastLevel = 1;
+
+    while (2 * ix->lastLevel <= n)
+        ix->lastLevel *= 2;
+
+    dal_setLength(&ix->tree, n + 1);
+    ix->tree.arrayp[0] = 0;
+
+    for (size_t k = 1; k <= n; ++k)
+        ix->tree.arrayp[k] = d->arrayp[rankOf(k, n, ix->lastLevel)];
+
+    return DAL_OK;
+}
+
+
+void dal_destroySearchIndex(DalSearchIndex *ix) {
+    dal_destroyDynarrLO(&ix->tree);
+    ix->lastLevel = 0;
+}
+
+
+size_t dal_pindexLowerBound(const DalSearchIndex *ix, size_t val) {
+    return indexBound(ix, val, false);
+}
+
+
+size_t dal_pindexUpperBound(const DalSearchIndex *ix, size_t val) {
+    return indexBound(ix, val, true);
+}
+
+#endif // DAL_PRIMITIVE_SUPPORT
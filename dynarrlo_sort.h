@@ -0,0 +1,156 @@
+//
+// Created by easy on 16.10.26.
+//
+
+#ifndef EASY_DYNARRLO_SORT_H
+#define EASY_DYNARRLO_SORT_H
+
+#include "dynarrlo.h"
+
+
+/**
+ * Compares two objects of a DynarrLO. Unlike the comparison function of
+ * \p qsort() , it receives the objects themselves, not pointers to the
+ * elements.
+ * @return A negative value if \p a is ordered before \p b , a positive value if
+ * it is ordered after \p b and 0 if both are equivalent.
+ */
+typedef int (*DalCompare) (const void *a, const void *b);
+
+
+/**
+ * Sorts the array in ascending order using introsort, i.e. quicksort with a
+ * median-of-three pivot that falls back to heapsort if it degenerates. Never
+ * allocates memory and takes O(n log n) time in the worst case. The order of
+ * equivalent objects is unspecified. Only for DynarrLO objects created with
+ * \p dal_createDynarrLO() .
+ * @param cmp Comparison function.
+ */
+void dal_sort(DynarrLO *d, DalCompare cmp);
+
+
+/**
+ * Sorts the array in ascending order using merge sort. Equivalent objects keep
+ * their relative order. A scratch buffer of length elements is allocated with
+ * the \p realloc() function of the DynarrLO. Sets error flag to
+ * \p DAL_ALLOCFAIL if it couldn't be allocated, in which case the array is not
+ * sorted. Only for DynarrLO objects created with \p dal_createDynarrLO() .
+ * @param cmp Comparison function.
+ */
+void dal_stableSort(DynarrLO *d, DalCompare cmp);
+
+
+#if DAL_PRIMITIVE_SUPPORT
+
+/**
+ * Sorts the array in ascending order using LSD radix sort, which needs no
+ * comparisons at all. Every pass distributes all values by 11 of their bits,
+ * passes in which all values share the same bits are skipped. Sorting takes
+ * O(n) time and is stable. A scratch buffer of length elements is allocated
+ * with the \p realloc() function of the DynarrLO. Sets error flag to
+ * \p DAL_ALLOCFAIL if it couldn't be allocated, in which case the array is not
+ * sorted. Short arrays are sorted by insertion without allocating.
+ */
+void dal_psort(DynarrLO *d);
+
+
+/**
+ * Finds the first element that is not less than \p val in a sorted array using
+ * a branchless binary search. The array must be sorted in ascending order.
+ * @param val Value to look for.
+ * @return Index of the first element >= \p val or length if there is none.
+ */
+size_t dal_plowerBound(DynarrLO *d, size_t val);
+
+
+/**
+ * Finds the first element that is greater than \p val in a sorted array using
+ * a branchless binary search. The array must be sorted in ascending order.
+ * @param val Value to look for.
+ * @return Index of the first element > \p val or length if there is none.
+ */
+size_t dal_pupperBound(DynarrLO *d, size_t val);
+
+
+/**
+ * Inserts a value into a sorted array behind all elements that are equal to
+ * it, so the array stays sorted. Error flag is set to \p DAL_ALLOCFAIL if
+ * memory couldn't be allocated.
+ * @param val Value to insert.
+ * @return Index at which \p val was inserted.
+ */
+size_t dal_pinsertSorted(DynarrLO *d, size_t val);
+
+
+/**
+ * Removes all elements that are equal to \p val from a sorted array.
+ * @param val Value to remove.
+ * @return Number of removed elements.
+ */
+size_t dal_peraseValue(DynarrLO *d, size_t val);
+
+
+
+/**
+ * A read-optimised search index over a sorted primitive array. It holds a copy
+ * of the values in Eytzinger layout, i.e. in the breadth-first order of a
+ * binary search tree. The first levels of the tree, which every search visits,
+ * share a few cache lines, and the descendants of a node four levels down are
+ * adjacent in memory, so they are prefetched while the search goes on. Lookups
+ * on large arrays are thus much faster than a binary search, which misses the
+ * cache on almost every probe.\n\n
+ *
+ * The index does not follow changes of the array it was built from. Rebuild it
+ * once the array has been modified.\n\n
+ *
+ * Do not modify or access the fields of this struct manually.
+ */
+typedef struct DalSearchIndex {
+    /**
+     * Values in Eytzinger layout, starting at index 1. Also holds the
+     * \p realloc() and \p free() functions.
+     */
+    DynarrLO tree;
+
+    /**
+     * Index of the first node of the last level of the tree.
+     */
+    size_t lastLevel;
+} DalSearchIndex;
+
+
+/**
+ * Builds a search index over a sorted primitive array. Uses the \p realloc()
+ * and \p free() functions of the array. Does nothing on failure.
+ * @param ix Pointer to search index object that shall be initialised.
+ * @param d Array sorted in ascending order.
+ * @return Error code indicating either success \p(DAL_OK), a null argument
+ * error \p(DAL_NULLARG) or failure to allocate the requested amount of memory
+ * \p (DAL_ALLOCFAIL) .
+ */
+DAL_ERROR dal_pcreateSearchIndex(DalSearchIndex *ix, const DynarrLO *d);
+
+
+/**
+ * Frees the search index and sets all struct fields to 0.
+ */
+void dal_destroySearchIndex(DalSearchIndex *ix);
+
+
+/**
+ * Equivalent to \p dal_plowerBound() on the array the index was built from.
+ * @param val Value to look for.
+ * @return Index of the first element >= \p val or length if there is none.
+ */
+size_t dal_pindexLowerBound(const DalSearchIndex *ix, size_t val);
+
+
+/**
+ * Equivalent to \p dal_pupperBound() on the array the index was built from.
+ * @param val Value to look for.
+ * @return Index of the first element > \p val or length if there is none.
+ */
+size_t dal_pindexUpperBound(const DalSearchIndex *ix, size_t val);
+
+#endif // DAL_PRIMITIVE_SUPPORT
+#endif // EASY_DYNARRLO_SORT_H
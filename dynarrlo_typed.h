@@ -0,0 +1,248 @@
+//
+// Created by easy on 16.10.26.
+//
+
+#ifndef EASY_DYNARRLO_TYPED_H
+#define EASY_DYNARRLO_TYPED_H
+
+#include <string.h>
+#include "dynarrlo.h"
+
+
+#if DAL_STATS
+// Adds n to a counter of the statistics of d, see dal_stats().
+#define DAL_TYPED_COUNT(d, counter, n) ((d)->stats.counter += (n))
+// Records the length of d if it is the largest so far.
+#define DAL_TYPED_PEAK(d)                                                      \
+    ((d)->stats.peakLength = (d)->length > (d)->stats.peakLength               \
+                             ? (d)->length : (d)->stats.peakLength)
+#else
+#define DAL_TYPED_COUNT(d, counter, n) ((void) 0)
+#define DAL_TYPED_PEAK(d) ((void) 0)
+#endif
+
+
+/**
+ * Defines a family of \p static \p inline functions that operate on a DynarrLO
+ * whose elements are of type \p T and are stored inline in its array, just
+ * like a DynarrLO created with \p dal_createDynarrLOSized() . Since these
+ * functions are visible to the compiler at the call site, it can inline them,
+ * hoist the bounds clamping out of loops and vectorise loops over the array.
+ * The out-of-line functions of the library remain available and may be mixed
+ * freely with the generated ones, in particular the sized functions.\n\n
+ *
+ * The generated functions behave like their out-of-line counterparts
+ * regarding the error flag, clamping of indices, the padding element and the
+ * \p DAL_STATS counters. Array growth is done out of line through
+ * \p dal_reserve() and, for arrays that opted into automatic shrinking, see
+ * \p dal_setAutoShrink() , shrinking through \p dal_autoShrink() .\n\n
+ *
+ * \p DAL_DEFINE(ints, int) defines the following functions. \p T is \p int
+ * and \p name is \p ints in this case.\n
+ * \p name_create()      like \p dal_createDynarrLOSized() with sizeof(T)\n
+ * \p name_data()        pointer to the first element\n
+ * \p name_ptr()         like \p dal_sget()\n
+ * \p name_get()         like \p dal_get() , 0 if \p index >= capacity\n
+ * \p name_uget()        like \p dal_uget() , unchecked\n
+ * \p name_getr()        like \p dal_getr()\n
+ * \p name_getLast()     like \p dal_getLast()\n
+ * \p name_pop()         like \p dal_pop()\n
+ * \p name_write()       like \p dal_write()\n
+ * \p name_uwrite()      like \p dal_uwrite() , unchecked\n
+ * \p name_append()      like \p dal_append()\n
+ * \p name_appendMany()  like \p dal_sappendMany()\n
+ * \p name_insert()      like \p dal_insert()\n
+ * \p name_insertMany()  like \p dal_sinsertMany()\n
+ * \p name_remove()      like \p dal_remove()\n
+ * \p name_removeLast()  like \p dal_removeLast()\n\n
+ *
+ * Use this macro once per element type at file scope. \p T must be a type that
+ * can be initialised with \p {0} .
+ * @param name Prefix of the generated functions.
+ * @param T Element type.
+ */
+#define DAL_DEFINE(name, T)                                                    \
+                                                                               \
+static inline DAL_ERROR name##_create(DynarrLO *d,                             \
+                                      size_t capacity,                         \
+                                      void *(*realloc) (void *, size_t),       \
+                                      void (*free) (void *)) {                 \
+    return dal_createDynarrLOSized(d, capacity, sizeof(T), realloc, free);     \
+}                                                                              \
+                                                                               \
+static inline T *name##_data(DynarrLO *d) {                                    \
+    return (T *) d->array;                                                     \
+}                                                                              \
+                                                                               \
+static inline T *name##_ptr(DynarrLO *d, size_t index) {                       \
+    d->error = index >= d->length;                                             \
+    DAL_TYPED_COUNT(d, outOfRange, d->error);                                  \
+    T *elem = (T *) d->array + (index < d->capacity ? index : d->capacity);    \
+    return index < d->capacity ? elem : NULL;                                  \
+}                                                                              \
+                                                                               \
+static inline T name##_get(DynarrLO *d, size_t index) {                        \
+    d->error = index >= d->length;                                             \
+    DAL_TYPED_COUNT(d, outOfRange, d->error);                                  \
+    index = index < d->capacity ? index : d->capacity;                         \
+    return ((T *) d->array)[index];                                            \
+}                                                                              \
+                                                                               \
+static inline T name##_uget(const DynarrLO *d, size_t index) {                 \
+    DAL_ASSERT(index < d->length);                                             \
+    return ((const T *) d->array)[index];                                      \
+}                                                                              \
+                                                                               \
+static inline T name##_getr(DynarrLO *d, size_t index) {                       \
+    index += d->length * (index >= d->capacity);                               \
+    d->error = index >= d->length;                                             \
+    DAL_TYPED_COUNT(d, outOfRange, d->error);                                  \
+    index = index < d->capacity ? index : d->capacity;                         \
+    return ((T *) d->array)[index];                                            \
+}                                                                              \
+                                                                               \
+static inline T name##_getLast(DynarrLO *d) {                                  \
+    size_t normlen = d->length - !!d->length;                                  \
+    T val1 = (T) {0};                                                          \
+    T val2 = ((T *) d->array)[normlen];                                        \
+    T val = d->length ? val2 : val1;                                           \
+    d->error = !d->length;                                                     \
+    DAL_TYPED_COUNT(d, outOfRange, d->error);                                  \
+    return val;                                                                \
+}                                                                              \
+                                                                               \
+static inline T name##_pop(DynarrLO *d) {                                      \
+    d->error = !d->length;                                                     \
+    DAL_TYPED_COUNT(d, outOfRange, d->error);                                  \
+    size_t normlen = d->length - !!d->length;                                  \
+    T val1 = (T) {0};                                                          \
+    T val2 = ((T *) d->array)[normlen];                                        \
+    T val = d->length ? val2 : val1;                                           \
+    DAL_TYPED_COUNT(d, removes, d->length - normlen);                          \
+    d->length = normlen;                                                       \
+                                                                               \
+    if (dal_autoShrinks(d))                                                    \
+        dal_autoShrink(d);                                                     \
+                                                                               \
+    return val;                                                                \
+}                                                                              \
+                                                                               \
+static inline void name##_write(DynarrLO *d, size_t index, T val) {            \
+    T *array = (T *) d->array;                                                 \
+    d->error = index >= d->length;                                             \
+    DAL_TYPED_COUNT(d, outOfRange, d->error);                                  \
+    index = index < d->capacity ? index : d->capacity;                         \
+    array[index] = val;                                                        \
+    array[d->capacity] = (T) {0};                                              \
+}                                                                              \
+                                                                               \
+static inline void name##_uwrite(DynarrLO *d, size_t index, T val) {           \
+    DAL_ASSERT(index < d->length);                                             \
+    ((T *) d->array)[index] = val;                                             \
+}                                                                              \
+                                                                               \
+static inline void name##_append(DynarrLO *d, T val) {                         \
+    if (d->length >= d->capacity && (dal_reserve(d, d->length + 1), d->error)) \
+        return;                                                                \
+                                                                               \
+    d->error = DAL_OK;                                                         \
+    ((T *) d->array)[d->length++] = val;                                       \
+    DAL_TYPED_COUNT(d, appends, 1);                                            \
+    DAL_TYPED_PEAK(d);                                                         \
+}                                                                              \
+                                                                               \
+static inline void name##_appendMany(DynarrLO *d,                              \
+                                     const T *vals,                            \
+                                     size_t num) {                             \
+    size_t length = d->length + num;                                           \
+                                                                               \
+    if (length > d->capacity && (dal_reserve(d, length), d->error))            \
+        return;                                                                \
+                                                                               \
+    d->error = DAL_OK;                                                         \
+    memcpy((T *) d->array + d->length, vals, num * sizeof(T));                 \
+    d->length = length;                                                        \
+    DAL_TYPED_COUNT(d, appends, num);                                          \
+    DAL_TYPED_PEAK(d);                                                         \
+}                                                                              \
+                                                                               \
+static inline void name##_insert(DynarrLO *d, size_t index, T val) {           \
+    DAL_ERROR error = index > d->length;                                       \
+    d->error = error;                                                          \
+    DAL_TYPED_COUNT(d, outOfRange, d->error);                                  \
+                                                                               \
+    if (error)                                                                 \
+        return;                                                                \
+                                                                               \
+    if (d->length >= d->capacity && (dal_reserve(d, d->length + 1), d->error)) \
+        return;                                                                \
+                                                                               \
+    T *array = (T *) d->array;                                                 \
+    memmove(array + index + 1,                                                 \
+            array + index,                                                     \
+            (d->length - index) * sizeof(T));                                  \
+                                                                               \
+    DAL_TYPED_COUNT(d, bytesMoved, (d->length - index) * sizeof(T));           \
+    DAL_TYPED_COUNT(d, inserts, 1);                                            \
+    array[index] = val;                                                        \
+    ++d->length;                                                               \
+    DAL_TYPED_PEAK(d);                                                         \
+}                                                                              \
+                                                                               \
+static inline void name##_insertMany(DynarrLO *d,                              \
+                                     size_t index,                             \
+                                     const T *vals,                            \
+                                     size_t num) {                             \
+    DAL_ERROR error = index > d->length;                                       \
+    size_t length = d->length + num;                                           \
+    d->error = error;                                                          \
+    DAL_TYPED_COUNT(d, outOfRange, d->error);                                  \
+                                                                               \
+    if (error || (length > d->capacity && (dal_reserve(d, length), d->error))) \
+        return;                                                                \
+                                                                               \
+    T *array = (T *) d->array;                                                 \
+    memmove(array + index + num,                                               \
+            array + index,                                                     \
+            (d->length - index) * sizeof(T));                                  \
+                                                                               \
+    memmove(array + index, vals, num * sizeof(T));                             \
+    DAL_TYPED_COUNT(d, bytesMoved, (d->length - index) * sizeof(T));           \
+    DAL_TYPED_COUNT(d, inserts, num);                                          \
+    d->length = length;                                                        \
+    DAL_TYPED_PEAK(d);                                                         \
+}                                                                              \
+                                                                               \
+static inline void name##_remove(DynarrLO *d, size_t index) {                  \
+    DAL_ERROR error = index >= d->length;                                      \
+    d->error = error;                                                          \
+    DAL_TYPED_COUNT(d, outOfRange, d->error);                                  \
+                                                                               \
+    if (error)                                                                 \
+        return;                                                                \
+                                                                               \
+    T *array = (T *) d->array;                                                 \
+    memmove(array + index,                                                     \
+            array + index + 1,                                                 \
+            (d->length - (index + 1)) * sizeof(T));                            \
+                                                                               \
+    DAL_TYPED_COUNT(d, bytesMoved, (d->length - (index + 1)) * sizeof(T));     \
+    DAL_TYPED_COUNT(d, removes, 1);                                            \
+    --d->length;                                                               \
+                                                                               \
+    if (dal_autoShrinks(d))                                                    \
+        dal_autoShrink(d);                                                     \
+}                                                                              \
+                                                                               \
+static inline void name##_removeLast(DynarrLO *d) {                            \
+    d->error = !d->length;                                                     \
+    DAL_TYPED_COUNT(d, outOfRange, d->error);                                  \
+    DAL_TYPED_COUNT(d, removes, !!d->length);                                  \
+    d->length -= !!d->length;                                                  \
+                                                                               \
+    if (dal_autoShrinks(d))                                                    \
+        dal_autoShrink(d);                                                     \
+}
+
+
+#endif // EASY_DYNARRLO_TYPED_H